@@ -0,0 +1,31 @@
+uniform sampler2D tex;
+uniform vec2 out_size;
+uniform int area;
+uniform int gray;
+
+out vec4 FragColor;
+
+#stk_include "utils/getObservationFootprint.frag"
+
+void main()
+{
+    ivec2 size = textureSize(tex, 0);
+    vec4 color;
+    if (area > 0)
+    {
+        ivec2 p0, p1;
+        getObservationFootprint(size, out_size, p0, p1);
+        vec4 sum = vec4(0.0);
+        for (int y = p0.y; y < p1.y; y++)
+            for (int x = p0.x; x < p1.x; x++)
+                sum += texelFetch(tex, observationTexel(ivec2(x, y), size), 0);
+        color = sum / float((p1.x - p0.x) * (p1.y - p0.y));
+    }
+    else
+        color = texelFetch(tex, observationTexel(getObservationCenter(size, out_size), size), 0);
+
+    if (gray > 0)
+        FragColor = vec4(dot(color.rgb, vec3(0.299, 0.587, 0.114)));
+    else
+        FragColor = color;
+}
@@ -0,0 +1,22 @@
+uniform sampler2D tex;
+uniform vec2 out_size;
+uniform float zn;
+uniform float zf;
+uniform int linearize;
+
+out vec4 Depth;
+
+#stk_include "utils/getObservationFootprint.frag"
+
+void main()
+{
+    // Depth is never averaged, that would create surfaces at object borders
+    ivec2 size = textureSize(tex, 0);
+    float d = texelFetch(tex, observationTexel(getObservationCenter(size, out_size), size), 0).x;
+    if (linearize > 0)
+    {
+        float c0 = zn * zf, c1 = zn - zf, c2 = zf;
+        d = c0 / (d * c1 + c2);
+    }
+    Depth = vec4(d);
+}
@@ -0,0 +1,45 @@
+uniform usampler2D tex;
+uniform vec2 out_size;
+uniform int mode;
+uniform int shift;
+
+out uvec4 Label;
+
+#stk_include "utils/getObservationFootprint.frag"
+
+// The most frequent label is found among at most MAX_SAMPLES x MAX_SAMPLES
+// texels of the footprint
+#define MAX_SAMPLES 8
+
+void main()
+{
+    ivec2 size = textureSize(tex, 0);
+    uint label;
+    if (mode > 0)
+    {
+        ivec2 p0, p1;
+        getObservationFootprint(size, out_size, p0, p1);
+        ivec2 stride = max((p1 - p0) / MAX_SAMPLES, 1);
+        uint samples[MAX_SAMPLES * MAX_SAMPLES];
+        int n = 0;
+        for (int y = p0.y; y < p1.y && y < p0.y + MAX_SAMPLES * stride.y; y += stride.y)
+            for (int x = p0.x; x < p1.x && x < p0.x + MAX_SAMPLES * stride.x; x += stride.x)
+                samples[n++] = texelFetch(tex, observationTexel(ivec2(x, y), size), 0).x >> uint(shift);
+        int best = 0;
+        label = samples[0];
+        for (int i = 0; i < n; i++)
+        {
+            int count = 0;
+            for (int j = 0; j < n; j++)
+                count += samples[j] == samples[i] ? 1 : 0;
+            if (count > best)
+            {
+                best = count;
+                label = samples[i];
+            }
+        }
+    }
+    else
+        label = texelFetch(tex, observationTexel(getObservationCenter(size, out_size), size), 0).x >> uint(shift);
+    Label = uvec4(label);
+}
@@ -0,0 +1,21 @@
+// Range [p0, p1) of source texels covered by the current output pixel.
+// Rows are counted top-down, such that the first row of the output is the top
+// of the image, use observationTexel to fetch them.
+void getObservationFootprint(ivec2 size, vec2 out_size, out ivec2 p0, out ivec2 p1)
+{
+    vec2 scale = vec2(size) / out_size;
+    vec2 xy = vec2(gl_FragCoord.x, out_size.y - gl_FragCoord.y);
+    p0 = ivec2(floor((xy - 0.5) * scale));
+    p1 = max(p0 + 1, ivec2(floor((xy + 0.5) * scale)));
+}
+
+ivec2 getObservationCenter(ivec2 size, vec2 out_size)
+{
+    vec2 xy = vec2(gl_FragCoord.x, out_size.y - gl_FragCoord.y);
+    return ivec2(xy * vec2(size) / out_size);
+}
+
+ivec2 observationTexel(ivec2 p, ivec2 size)
+{
+    return ivec2(p.x, size.y - 1 - p.y);
+}
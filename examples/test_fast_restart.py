@@ -0,0 +1,71 @@
+import argparse
+import sys
+import pystk
+import numpy as np
+
+# Kart and item state that a restart has to bring back
+FIELDS = ['kart_location', 'kart_rotation', 'kart_velocity', 'kart_attachment', 'kart_powerup', 'kart_powerup_num',
+          'item_location', 'item_type']
+
+
+def run(race, warmup_sa, random_sa):
+    race.start()
+    # Drive around first, so the restart has something to undo
+    for a, s in warmup_sa:
+        race.step(pystk.Action(acceleration=a, steer=2*s-1, fire=True))
+    race.restart()
+
+    states = []
+    w = pystk.WorldStateArrays()
+    for a, s in random_sa:
+        race.step(pystk.Action(acceleration=a, steer=2*s-1, fire=True))
+        w.update(race)
+        # update fills the arrays in place
+        states.append({f: np.array(getattr(w, f)) for f in FIELDS})
+    race.stop()
+    return states
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Check that a restart from the snapshot of RaceConfig.fast_restart '
+                                                 'matches a restart with World::reset, step by step')
+    parser.add_argument('-t', '--track')
+    parser.add_argument('-k', '--kart', default='')
+    parser.add_argument('-s', '--step_size', type=float)
+    parser.add_argument('-n', '--num_kart', type=int, default=1)
+    parser.add_argument('--warmup', type=int, default=100, help='Steps before the restart')
+    parser.add_argument('--steps', type=int, default=500, help='Steps compared after the restart')
+    parser.add_argument('--tolerance', type=float, default=1e-4)
+    args = parser.parse_args()
+
+    pystk.init(pystk.GraphicsConfig.none())
+
+    race_config = pystk.RaceConfig(render=False, num_kart=args.num_kart)
+    if args.kart != '':
+        race_config.players[0].kart = args.kart
+    if args.track is not None:
+        race_config.track = args.track
+    if args.step_size is not None:
+        race_config.step_size = args.step_size
+
+    warmup_sa = np.random.rand(args.warmup, 2)
+    random_sa = np.random.rand(args.steps, 2)
+
+    states = {}
+    for fast_restart in [False, True]:
+        race_config.fast_restart = fast_restart
+        race = pystk.Race(race_config)
+        states[fast_restart] = run(race, warmup_sa, random_sa)
+        del race
+
+    pystk.clean()
+
+    for i, (reset, restored) in enumerate(zip(states[False], states[True])):
+        for f in FIELDS:
+            a, b = reset[f], restored[f]
+            if a.shape != b.shape or not np.allclose(a, b, atol=args.tolerance):
+                print('Mismatch of %s in step %d after the restart' % (f, i))
+                print('  World::reset:', a)
+                print('  snapshot:    ', b)
+                sys.exit(1)
+    print('Restored snapshot matches World::reset for %d steps' % len(random_sa))
@@ -0,0 +1,80 @@
+import argparse
+import sys
+import pystk
+import numpy as np
+
+# Kart and item state a snapshot has to bring back
+FIELDS = ['kart_location', 'kart_rotation', 'kart_velocity', 'kart_finished_laps', 'kart_distance_down_track',
+          'kart_attachment', 'kart_powerup', 'kart_powerup_num', 'item_location', 'item_type']
+
+
+def run(race, random_sa):
+    states = []
+    w = pystk.WorldStateArrays()
+    for a, s in random_sa:
+        race.step(pystk.Action(acceleration=a, steer=2*s-1, fire=True))
+        w.update(race)
+        # update fills the arrays in place
+        states.append({f: np.array(getattr(w, f)) for f in FIELDS})
+    return states
+
+
+def compare(expected, actual, name, tolerance):
+    for i, (a, b) in enumerate(zip(expected, actual)):
+        for f in FIELDS:
+            if a[f].shape != b[f].shape or not np.allclose(a[f], b[f], atol=tolerance):
+                print('%s: mismatch of %s in step %d after load_state' % (name, f, i))
+                print('  first run:', a[f])
+                print('  reloaded: ', b[f])
+                sys.exit(1)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Check that stepping from a save_state snapshot is deterministic')
+    parser.add_argument('-t', '--track')
+    parser.add_argument('-k', '--kart', default='')
+    parser.add_argument('-s', '--step_size', type=float)
+    parser.add_argument('-n', '--num_kart', type=int, default=1)
+    parser.add_argument('--warmup', type=int, default=100, help='Steps before the snapshot')
+    parser.add_argument('--steps', type=int, default=500, help='Steps compared after the snapshot')
+    # Bullet keeps its contact points, they are not part of a snapshot
+    parser.add_argument('--tolerance', type=float, default=1e-4)
+    args = parser.parse_args()
+
+    pystk.init(pystk.GraphicsConfig.none())
+
+    race_config = pystk.RaceConfig(render=False, num_kart=args.num_kart)
+    if args.kart != '':
+        race_config.players[0].kart = args.kart
+    if args.track is not None:
+        race_config.track = args.track
+    if args.step_size is not None:
+        race_config.step_size = args.step_size
+
+    race = pystk.Race(race_config)
+    race.start()
+    run(race, np.random.rand(args.warmup, 2))
+
+    # save -> step -> load -> step has to repeat the same steps
+    random_sa = np.random.rand(args.steps, 2)
+    state = race.save_state()
+    expected = run(race, random_sa)
+    race.load_state(state)
+    compare(expected, run(race, random_sa), 'save_state', args.tolerance)
+
+    # A broken snapshot raises a ValueError and leaves the race as it was
+    race.load_state(state)
+    for broken in [state[:len(state) // 2], state[:8], b'', state + b'\0']:
+        try:
+            race.load_state(broken)
+        except ValueError:
+            pass
+        else:
+            print('load_state accepted a broken snapshot of %d bytes' % len(broken))
+            sys.exit(1)
+    compare(expected, run(race, random_sa), 'broken snapshot', args.tolerance)
+
+    race.stop()
+    del race
+    pystk.clean()
+    print('Steps after load_state match for %d steps' % len(random_sa))
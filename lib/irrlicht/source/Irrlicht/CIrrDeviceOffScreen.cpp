@@ -93,9 +93,13 @@ CIrrDeviceOffScreen::CIrrDeviceOffScreen(const SIrrlichtCreationParameters& para
     // create cursor control
     CursorControl = new DummyCursorControl();
 
-    bool success = initEGL();
-    if (!success)
-        return;
+    // The null driver does not render, so it needs no EGL context
+    if (CreationParams.DriverType != video::EDT_NULL)
+    {
+        bool success = initEGL();
+        if (!success)
+            return;
+    }
     
     // create driver
     createDriver();
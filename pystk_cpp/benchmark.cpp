@@ -0,0 +1,424 @@
+// Native throughput benchmark of pystk, without python in the loop.
+// Every phase of a race is timed separately and written as JSON with percentiles, see docs/benchmark.rst
+#include <pybind11/embed.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "pystk.hpp"
+#include "state.hpp"
+#include "config/stk_config.hpp"
+#include "graphics/gl_headers.hpp"
+#include "graphics/irr_driver.hpp"
+#include "modes/world.hpp"
+#include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+#include "utils/log.hpp"
+#include "utils/phase_timer.hpp"
+
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+namespace py = pybind11;
+typedef std::chrono::steady_clock Clock;
+
+static double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static std::vector<std::string> split(const std::string & s) {
+    std::vector<std::string> r;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (item.size())
+            r.push_back(item);
+    return r;
+}
+
+static std::string quote(const std::string & s) {
+    std::string r = "\"";
+    for(char c: s) {
+        if (c == '"' || c == '\\') r += '\\';
+        r += c;
+    }
+    return r + "\"";
+}
+
+struct Options {
+    std::vector<std::string> tracks, presets = {"ld", "sd", "hd", "none"}, resolutions = {"128x96", "600x400"};
+    std::vector<int> num_karts = {1, 8}, num_players = {1}, physics_threads = {1}, physics_fps = {0};
+    std::vector<std::string> broadphases = {"axis_sweep"};
+    std::string kart, output;
+    int steps = 500, warmup = 10, restarts = 5;
+    float step_size = 0.1;
+};
+
+// Durations of one measurement, reported in milliseconds
+class Samples {
+protected:
+    std::vector<double> v_;
+public:
+    void add(double seconds) { v_.push_back(seconds); }
+    bool empty() const { return v_.empty(); }
+    std::string json() const {
+        std::vector<double> v = v_;
+        std::sort(v.begin(), v.end());
+        double sum = 0;
+        for(double x: v) sum += x;
+        // Nearest rank percentile
+        auto p = [&v](double q) { return v[std::min(v.size() - 1, (size_t)(q * v.size()))]; };
+        char buf[256];
+        snprintf(buf, sizeof(buf), "{\"n\": %d, \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                 (int)v.size(), 1e3 * sum / v.size(), 1e3 * v.front(), 1e3 * p(0.5), 1e3 * p(0.9), 1e3 * p(0.99), 1e3 * v.back());
+        return buf;
+    }
+};
+
+// All measurements of one configuration, in the order they are written
+class Report {
+protected:
+    std::vector<std::pair<std::string, Samples> > samples_;
+    std::vector<std::pair<std::string, std::string> > values_;
+public:
+    Samples & operator[](const std::string & name) {
+        for(auto & s: samples_)
+            if (s.first == name) return s.second;
+        samples_.push_back({name, Samples()});
+        return samples_.back().second;
+    }
+    void set(const std::string & name, const std::string & json_value) { values_.push_back({name, json_value}); }
+    std::string json(const std::string & indent) const {
+        std::string r = "{";
+        const char * sep = "\n";
+        for(const auto & v: values_) {
+            r += sep + indent + "  " + quote(v.first) + ": " + v.second;
+            sep = ",\n";
+        }
+        for(const auto & s: samples_)
+            if (!s.second.empty()) {
+                r += sep + indent + "  " + quote(s.first) + ": " + s.second.json();
+                sep = ",\n";
+            }
+        return r + "\n" + indent + "}";
+    }
+};
+
+// Runs the steps of a race like PySTKRace::step, but times each phase
+class BenchmarkRace: public PySTKRace {
+protected:
+    std::shared_ptr<PyWorldState> state_;
+    std::vector<char> scratch_;
+public:
+    BenchmarkRace(const PySTKRaceConfig & config): PySTKRace(config) {}
+    bool step(Report & report, bool measure) {
+        auto lock = activate(this);
+        const float dt = config_.step_size;
+        if (!World::getWorld()) return false;
+        int ticks = stk_config->time2Ticks(time_leftover_ + dt);
+
+        // Like PySTKRace::step, only keep the collisions of this step
+        collisions_.clear();
+        PhaseTimer::reset();
+        auto t0 = Clock::now();
+        bool running = update(dt);
+        double t_update = seconds_since(t0);
+        double t_physics = PhaseTimer::getTotal(PhaseTimer::PHASE_PHYSICS);
+        double t_controller = PhaseTimer::getTotal(PhaseTimer::PHASE_CONTROLLER);
+
+        t0 = Clock::now();
+        if (config_.render) {
+            World::getWorld()->updateGraphics(dt);
+            irr_driver->minimalUpdate(dt);
+        } else {
+            World::getWorld()->updateGraphicsMinimal(dt);
+        }
+        double t_graphics = seconds_since(t0);
+
+        // Wait for the GPU, such that the render time is not hidden in the readback
+        double t_render = 0;
+        if (config_.render) {
+            t0 = Clock::now();
+            render(dt);
+            glFinish();
+            t_render = seconds_since(t0);
+        }
+
+        t0 = Clock::now();
+        for(const auto & d: render_data_)
+            for(const auto & b: {d->color_buf_, d->depth_buf_, d->instance_buf_})
+                if (b) {
+                    scratch_.resize(std::max(scratch_.size(), (size_t)b->size()));
+                    b->copy(scratch_.data());
+                }
+        double t_readback = seconds_since(t0);
+
+        t0 = Clock::now();
+        updateWorldState(state_, this);
+        double t_state = seconds_since(t0);
+
+        if (measure) {
+            report["step"].add(t_update + t_graphics + t_render + t_readback);
+            report["update"].add(t_update);
+            if (ticks > 0) {
+                report["physics_tick"].add(t_physics / ticks);
+                report["controller_tick"].add(t_controller / ticks);
+            }
+            report["update_graphics"].add(t_graphics);
+            if (render_data_.size()) {
+                report["render_view"].add(t_render / render_data_.size());
+                report["readback"].add(t_readback);
+            }
+            report["world_state"].add(t_state);
+        }
+        return running;
+    }
+};
+
+static PySTKRaceConfig::Broadphase broadphase(const std::string & name) {
+    if (name == "axis_sweep") return PySTKRaceConfig::AXIS_SWEEP;
+    if (name == "dbvt") return PySTKRaceConfig::DBVT;
+    throw std::invalid_argument("Unknown broadphase '" + name + "' (use axis_sweep or dbvt)");
+}
+
+static PySTKGraphicsConfig preset(const std::string & name) {
+    if (name == "hd") return PySTKGraphicsConfig::hd();
+    if (name == "sd") return PySTKGraphicsConfig::sd();
+    if (name == "ld") return PySTKGraphicsConfig::ld();
+    if (name == "none") return PySTKGraphicsConfig::none();
+    throw std::invalid_argument("Unknown graphics preset '" + name + "' (use hd, sd, ld or none)");
+}
+
+// Benchmarks one graphics preset and resolution, init can only be called once per process
+static std::string run(const Options & o) {
+    const std::string & resolution = o.resolutions[0];
+    PySTKGraphicsConfig gc = preset(o.presets[0]);
+    if (sscanf(resolution.c_str(), "%dx%d", &gc.screen_width, &gc.screen_height) != 2)
+        throw std::invalid_argument("Resolutions have the format WIDTHxHEIGHT, got '" + resolution + "'");
+
+    PhaseTimer::setEnabled(true);
+    Report init;
+    auto t0 = Clock::now();
+    PySTKRace::init(gc);
+    init["init"].add(seconds_since(t0));
+
+    std::vector<std::string> tracks = o.tracks;
+    if (tracks.empty())
+        for(const auto & t: PySTKRace::listTracks()) {
+            const Track * track = track_manager->getTrack(t);
+            if (track && track->isRaceTrack())
+                tracks.push_back(t);
+        }
+
+    std::string r = "{\n    \"preset\": " + quote(o.presets[0]) + ",\n    \"width\": " + std::to_string(gc.screen_width) +
+                    ",\n    \"height\": " + std::to_string(gc.screen_height) + ",\n    \"init\": " + init.json("    ") + ",\n    \"tracks\": {";
+    const char * track_sep = "\n";
+    for(const auto & track: tracks) {
+        std::cerr << "benchmark: " << o.presets[0] << " " << resolution << " " << track << std::endl;
+        std::string runs;
+        bool first_start = true;
+        for(int nk: o.num_karts)
+            for(int np: o.num_players)
+            for(const auto & bp: o.broadphases)
+            for(int nt: o.physics_threads)
+            for(int fps: o.physics_fps) {
+                if (np > nk) continue;
+                PySTKRaceConfig config;
+                config.track = track;
+                config.num_kart = nk;
+                config.physics_broadphase = broadphase(bp);
+                config.physics_threads = nt;
+                config.physics_fps = fps;
+                config.step_size = o.step_size;
+                config.render = gc.render;
+                config.laps = 100;
+                config.players.clear();
+                for(int i=0; i<np; i++)
+                    config.players.push_back({o.kart, PySTKPlayerConfig::AI_CONTROL});
+
+                Report report;
+                report.set("num_kart", std::to_string(nk));
+                report.set("num_player", std::to_string(np));
+                report.set("broadphase", quote(bp));
+                report.set("physics_threads", std::to_string(nt));
+                report.set("physics_fps", std::to_string(fps ? fps : stk_config->getDefaultPhysicsFPS()));
+                std::unique_ptr<BenchmarkRace> race;
+                // The first start of a track loads it from disk, later ones find its files in the caches
+                t0 = Clock::now();
+                race.reset(new BenchmarkRace(config));
+                race->start();
+                report[first_start ? "load" : "start"].add(seconds_since(t0));
+                first_start = false;
+
+                for(int i=0; i<o.warmup; i++)
+                    race->step(report, false);
+                t0 = Clock::now();
+                int steps = 0;
+                for(; steps<o.steps; steps++)
+                    if (!race->step(report, true)) break;
+                double total = seconds_since(t0);
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%.2f", steps / total);
+                report.set("steps_per_second", buf);
+
+                for(int i=0; i<o.restarts; i++) {
+                    t0 = Clock::now();
+                    race->restart();
+                    report["restart"].add(seconds_since(t0));
+                }
+                race->stop();
+                race.reset();
+
+                runs += std::string(runs.size() ? ",\n" : "\n") + "        " + report.json("        ");
+            }
+        r += track_sep + std::string("      ") + quote(track) + ": [" + runs + "\n      ]";
+        track_sep = ",\n";
+    }
+    PySTKRace::clean();
+    return r + "\n    }\n  }";
+}
+
+static std::string join(const std::vector<std::string> & v) {
+    std::string r;
+    for(const auto & s: v) r += (r.size() ? "," : "") + s;
+    return r;
+}
+static std::string join(const std::vector<int> & v) {
+    std::vector<std::string> s;
+    for(int i: v) s.push_back(std::to_string(i));
+    return join(s);
+}
+
+static void usage() {
+    std::cerr << "Usage: pystk_benchmark [options]\n"
+              << "  -t, --tracks T1,T2,..     Tracks to benchmark (default: all race tracks)\n"
+              << "  -k, --num-karts N1,..     Number of karts per race (default: 1,8)\n"
+              << "  -p, --num-players N1,..   Number of players (rendered views) per race (default: 1)\n"
+              << "  -b, --broadphase B1,..    Physics broadphases axis_sweep or dbvt (default: axis_sweep)\n"
+              << "  -j, --physics-threads N1,.. Threads that solve the physics islands (default: 1)\n"
+              << "  -f, --physics-fps F1,..   Physics rates, 0 is the default rate (default: 0)\n"
+              << "  -r, --resolutions WxH,..  Screen resolutions (default: 128x96,600x400)\n"
+              << "  -g, --presets P1,..       Graphics presets hd, sd, ld or none (default: ld,sd,hd,none)\n"
+              << "  -n, --steps N             Measured steps per race (default: 500)\n"
+              << "  -w, --warmup N            Steps before measuring (default: 10)\n"
+              << "  -R, --restarts N          Measured restarts per race (default: 5)\n"
+              << "  -s, --step-size S         Step size in seconds (default: 0.1)\n"
+              << "      --kart K              Kart of all players (default: the default kart)\n"
+              << "  -o, --output FILE         JSON report (default: stdout)\n";
+}
+
+int main(int argc, char * argv[]) {
+    Options o;
+    try {
+        for(int i=1; i<argc; i++) {
+            std::string a = argv[i];
+            if (a == "-h" || a == "--help") {
+                usage();
+                return 0;
+            }
+            if (i+1 >= argc)
+                throw std::invalid_argument("Missing value of " + a);
+            std::string v = argv[++i];
+            if (a == "-t" || a == "--tracks") o.tracks = split(v);
+            else if (a == "-g" || a == "--presets") o.presets = split(v);
+            else if (a == "-r" || a == "--resolutions") o.resolutions = split(v);
+            else if (a == "-k" || a == "--num-karts") { o.num_karts.clear(); for(auto s: split(v)) o.num_karts.push_back(std::stoi(s)); }
+            else if (a == "-p" || a == "--num-players") { o.num_players.clear(); for(auto s: split(v)) o.num_players.push_back(std::stoi(s)); }
+            else if (a == "-b" || a == "--broadphase") { o.broadphases = split(v); for(const auto & b: o.broadphases) broadphase(b); }
+            else if (a == "-j" || a == "--physics-threads") { o.physics_threads.clear(); for(auto s: split(v)) o.physics_threads.push_back(std::stoi(s)); }
+            else if (a == "-f" || a == "--physics-fps") { o.physics_fps.clear(); for(auto s: split(v)) o.physics_fps.push_back(std::stoi(s)); }
+            else if (a == "-n" || a == "--steps") o.steps = std::stoi(v);
+            else if (a == "-w" || a == "--warmup") o.warmup = std::stoi(v);
+            else if (a == "-R" || a == "--restarts") o.restarts = std::stoi(v);
+            else if (a == "-s" || a == "--step-size") o.step_size = std::stof(v);
+            else if (a == "--kart") o.kart = v;
+            else if (a == "-o" || a == "--output") o.output = v;
+            else throw std::invalid_argument("Unknown argument " + a);
+        }
+        if (o.presets.empty() || o.resolutions.empty() || o.num_karts.empty() || o.num_players.empty() ||
+            o.broadphases.empty() || o.physics_threads.empty() || o.physics_fps.empty())
+            throw std::invalid_argument("Empty preset, resolution, kart, player, broadphase or thread list");
+    } catch (std::exception & e) {
+        std::cerr << e.what() << std::endl;
+        usage();
+        return 1;
+    }
+
+    std::string configs;
+    if (o.presets.size() == 1 && o.resolutions.size() == 1) {
+        // Benchmark in this process
+        if (!getenv("SUPERTUXKART_DATADIR"))
+#ifdef WIN32
+            _putenv_s("SUPERTUXKART_DATADIR", PYSTK_SOURCE_DIR);
+#else
+            setenv("SUPERTUXKART_DATADIR", PYSTK_SOURCE_DIR, 0);
+#endif
+#ifdef WIN32
+        _putenv_s("IRR_DEVICE_TYPE", "offscreen");
+#else
+        setenv("IRR_DEVICE_TYPE", "offscreen", 0);
+#endif
+        Log::setLogLevel(Log::LL_ERROR);
+        // The render buffers are numpy arrays
+        py::scoped_interpreter python;
+        try {
+            configs = "\n  " + run(o);
+        } catch (std::exception & e) {
+            std::cerr << "benchmark failed: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        // Every preset and resolution runs in its own process
+        int n = 0;
+        for(const auto & p: o.presets)
+            for(const auto & res: o.resolutions) {
+                std::string part = (o.output.size() ? o.output : "pystk_benchmark") + "." + std::to_string(getpid()) + "." + std::to_string(n++) + ".part";
+                std::string cmd = quote(argv[0]) + " -g " + p + " -r " + res + " -k " + join(o.num_karts) + " -p " + join(o.num_players) +
+                                  " -b " + join(o.broadphases) + " -j " + join(o.physics_threads) + " -f " + join(o.physics_fps) +
+                                  " -n " + std::to_string(o.steps) + " -w " + std::to_string(o.warmup) + " -R " + std::to_string(o.restarts) +
+                                  " -s " + std::to_string(o.step_size) + " -o " + quote(part);
+                if (o.tracks.size()) cmd += " -t " + quote(join(o.tracks));
+                if (o.kart.size()) cmd += " --kart " + quote(o.kart);
+                if (std::system(cmd.c_str()) != 0) {
+                    std::cerr << "benchmark of preset " << p << " at " << res << " failed" << std::endl;
+                    std::remove(part.c_str());
+                    continue;
+                }
+                // Take the configs of the child report
+                std::ifstream f(part);
+                std::string child((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+                f.close();
+                std::remove(part.c_str());
+                size_t b = child.find('['), e = child.rfind(']');
+                if (b == std::string::npos || e == std::string::npos || e <= b) continue;
+                configs += (configs.size() ? "," : "") + child.substr(b + 1, e - b - 1);
+                while (configs.size() && (configs.back() == '\n' || configs.back() == ' '))
+                    configs.pop_back();
+            }
+    }
+
+    std::ostringstream s;
+    s << "{\n  \"steps\": " << o.steps << ",\n  \"step_size\": " << o.step_size << ",\n  \"configs\": [" << configs << "\n  ]\n}\n";
+    if (o.output.size()) {
+        std::ofstream f(o.output);
+        f << s.str();
+        if (!f) {
+            std::cerr << "Can not write " << o.output << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << s.str();
+    }
+    return 0;
+}
@@ -8,6 +8,7 @@
 #include <vector>
 #include "pickle.hpp"
 #include "pystk.hpp"
+#include "shm_ring.hpp"
 #include "state.hpp"
 #include "view.hpp"
 #include "utils/objecttype.h"
@@ -22,14 +23,21 @@ using namespace pybind11::literals;
 
 PYBIND11_MAKE_OPAQUE(std::vector<PySTKPlayerConfig>);
 
-void path_and_init(const PySTKGraphicsConfig & config) {
+void set_data_path() {
     auto sys = py::module::import("sys"), os = py::module::import("os");
     auto path = os.attr("path"), env = os.attr("environ");
     auto module_path = path.attr("join")(path.attr("dirname")(path.attr("abspath")(sys.attr("modules")["pystk"].attr("__file__"))), "pystk_data");
     // Give supertuxkart a hint where the assets are
     env["SUPERTUXKART_DATADIR"] = module_path;
+}
+void path_and_init(const PySTKGraphicsConfig & config) {
+    set_data_path();
     PySTKRace::init(config);
 }
+void path_and_preload() {
+    set_data_path();
+    PySTKRace::preload();
+}
 PYBIND11_MODULE(pystk, m) {
     m.doc() = "Python SuperTuxKart interface";
 
@@ -85,7 +93,7 @@ PYBIND11_MODULE(pystk, m) {
     {
         py::class_<PySTKGraphicsConfig, std::shared_ptr<PySTKGraphicsConfig>> cls(m, "GraphicsConfig", "SuperTuxKart graphics configuration.");
         
-        cls.def(py::init<int, int, bool, bool, bool, bool, bool, int, bool, bool, bool, bool, bool, bool, int>(), py::arg("screen_width") = 600, py::arg("screen_height") = 400, py::arg("glow") = false, py::arg("") = true, py::arg("") = true, py::arg("") = true, py::arg("") = true, py::arg("particles_effects") = 2, py::arg("animated_characters") = true, py::arg("motionblur") = true, py::arg("mlaa") = true, py::arg("texture_compression") = true, py::arg("ssao") = true, py::arg("degraded_IBL") = false, py::arg("high_definition_textures") = 2 | 1)
+        cls.def(py::init<int, int, bool, bool, bool, bool, bool, int, bool, bool, bool, bool, bool, bool, int, bool, int>(), py::arg("screen_width") = 600, py::arg("screen_height") = 400, py::arg("glow") = false, py::arg("") = true, py::arg("") = true, py::arg("") = true, py::arg("") = true, py::arg("particles_effects") = 2, py::arg("animated_characters") = true, py::arg("motionblur") = true, py::arg("mlaa") = true, py::arg("texture_compression") = true, py::arg("ssao") = true, py::arg("degraded_IBL") = false, py::arg("high_definition_textures") = 2 | 1, py::arg("render") = true, py::arg("max_texture_size") = 512)
         .def_readwrite("screen_width", &PySTKGraphicsConfig::screen_width, "Width of the rendering surface")
         .def_readwrite("screen_height", &PySTKGraphicsConfig::screen_height, "Height of the rendering surface")
         .def_readwrite("glow", &PySTKGraphicsConfig::glow, "Enable glow around pickup objects")
@@ -100,12 +108,15 @@ PYBIND11_MODULE(pystk, m) {
         .def_readwrite("texture_compression", &PySTKGraphicsConfig::texture_compression, "Use texture compression")
         .def_readwrite("ssao", &PySTKGraphicsConfig::ssao, "Enable screen space ambient occlusion")
         .def_readwrite("degraded_IBL", &PySTKGraphicsConfig::degraded_IBL, "Disable specular IBL")
-        .def_readwrite("high_definition_textures", &PySTKGraphicsConfig::high_definition_textures, "Enable high definition textures 0 / 2");
+        .def_readwrite("high_definition_textures", &PySTKGraphicsConfig::high_definition_textures, "Enable high definition textures 0 / 2")
+        .def_readwrite("render", &PySTKGraphicsConfig::render, "Load graphics and create an OpenGL context. Set to False for a physics-only mode without rendering")
+        .def_readwrite("max_texture_size", &PySTKGraphicsConfig::max_texture_size, "Maximum texture size, only used without high_definition_textures");
         add_pickle(cls);
         
         cls.def_static("hd", &PySTKGraphicsConfig::hd, "High-definitaiton graphics settings");
         cls.def_static("sd", &PySTKGraphicsConfig::sd, "Standard-definition graphics settings");
         cls.def_static("ld", &PySTKGraphicsConfig::ld, "Low-definition graphics settings");
+        cls.def_static("none", &PySTKGraphicsConfig::none, "No graphics, only the physics simulation runs");
     }
     
     {
@@ -137,8 +148,34 @@ PYBIND11_MODULE(pystk, m) {
             .value("CAPTURE_THE_FLAG", PySTKRaceConfig::RaceMode::CAPTURE_THE_FLAG)
             .value("SOCCER", PySTKRaceConfig::RaceMode::SOCCER);
         
+        py::enum_<PySTKRaceConfig::ColorFormat>(cls, "ColorFormat")
+            .value("RGB", PySTKRaceConfig::ColorFormat::COLOR_RGB)
+            .value("GRAY", PySTKRaceConfig::ColorFormat::COLOR_GRAY)
+            .value("NONE", PySTKRaceConfig::ColorFormat::COLOR_NONE);
+        
+        py::enum_<PySTKRaceConfig::DepthFormat>(cls, "DepthFormat")
+            .value("FLOAT", PySTKRaceConfig::DepthFormat::DEPTH_FLOAT)
+            .value("UINT16", PySTKRaceConfig::DepthFormat::DEPTH_UINT16)
+            .value("LINEAR_FLOAT", PySTKRaceConfig::DepthFormat::DEPTH_LINEAR_FLOAT)
+            .value("LINEAR_HALF", PySTKRaceConfig::DepthFormat::DEPTH_LINEAR_HALF)
+            .value("NONE", PySTKRaceConfig::DepthFormat::DEPTH_NONE);
+        
+        py::enum_<PySTKRaceConfig::InstanceFormat>(cls, "InstanceFormat")
+            .value("ID", PySTKRaceConfig::InstanceFormat::INSTANCE_ID)
+            .value("OBJECT_TYPE", PySTKRaceConfig::InstanceFormat::INSTANCE_OBJECT_TYPE)
+            .value("NONE", PySTKRaceConfig::InstanceFormat::INSTANCE_NONE);
+        
+        py::enum_<PySTKRaceConfig::Filter>(cls, "Filter")
+            .value("NEAREST", PySTKRaceConfig::Filter::NEAREST)
+            .value("AREA", PySTKRaceConfig::Filter::AREA)
+            .value("MODE", PySTKRaceConfig::Filter::MODE);
+        
+        py::enum_<PySTKRaceConfig::Broadphase>(cls, "Broadphase")
+            .value("AXIS_SWEEP", PySTKRaceConfig::Broadphase::AXIS_SWEEP)
+            .value("DBVT", PySTKRaceConfig::Broadphase::DBVT);
+        
         cls
-        .def(py::init<int,PySTKRaceConfig::RaceMode,std::vector<PySTKPlayerConfig>,std::string,bool,int,int,int,float,bool>(), py::arg("difficulty") = 2, py::arg("mode") = PySTKRaceConfig::NORMAL_RACE, py::arg("players") = std::vector<PySTKPlayerConfig>{{"",PySTKPlayerConfig::PLAYER_CONTROL}}, py::arg("track") = "", py::arg("reverse") = false, py::arg("laps") = 3, py::arg("seed") = 0, py::arg("num_kart") = 1, py::arg("step_size") = 0.1, py::arg("render") = true)
+        .def(py::init<int,PySTKRaceConfig::RaceMode,std::vector<PySTKPlayerConfig>,std::string,bool,int,int,int,float,bool,int,bool,PySTKRaceConfig::ColorFormat,PySTKRaceConfig::DepthFormat,PySTKRaceConfig::InstanceFormat,int,int,int,PySTKRaceConfig::Filter,PySTKRaceConfig::Filter,bool,PySTKRaceConfig::Broadphase,int,int,int,int>(), py::arg("difficulty") = 2, py::arg("mode") = PySTKRaceConfig::NORMAL_RACE, py::arg("players") = std::vector<PySTKPlayerConfig>{{"",PySTKPlayerConfig::PLAYER_CONTROL}}, py::arg("track") = "", py::arg("reverse") = false, py::arg("laps") = 3, py::arg("seed") = 0, py::arg("num_kart") = 1, py::arg("step_size") = 0.1, py::arg("render") = true, py::arg("readback_buffers") = 2, py::arg("zero_copy") = false, py::arg("color_format") = PySTKRaceConfig::COLOR_RGB, py::arg("depth_format") = PySTKRaceConfig::DEPTH_FLOAT, py::arg("instance_format") = PySTKRaceConfig::INSTANCE_ID, py::arg("observation_width") = 0, py::arg("observation_height") = 0, py::arg("frame_stack") = 1, py::arg("color_filter") = PySTKRaceConfig::AREA, py::arg("instance_filter") = PySTKRaceConfig::NEAREST, py::arg("fast_restart") = false, py::arg("physics_broadphase") = PySTKRaceConfig::AXIS_SWEEP, py::arg("physics_threads") = 1, py::arg("physics_fps") = 0, py::arg("physics_substeps") = 1, py::arg("physics_solver_iterations") = 0)
         .def_readwrite("difficulty", &PySTKRaceConfig::difficulty, "Skill of AI players 0..2")
         .def_readwrite("mode", &PySTKRaceConfig::mode, "Specify the type of race")
         .def_readwrite("players", &PySTKRaceConfig::players, "List of all agent players")
@@ -148,16 +185,33 @@ PYBIND11_MODULE(pystk, m) {
         .def_readwrite("seed", &PySTKRaceConfig::seed, "Random seed")
         .def_readwrite("num_kart", &PySTKRaceConfig::num_kart, "Total number of karts, fill the race with num_kart - len(players) AI karts")
         .def_readwrite("step_size", &PySTKRaceConfig::step_size, "Game time between different step calls")
-        .def_readwrite("render", &PySTKRaceConfig::render, "Is rendering enabled?");
+        .def_readwrite("render", &PySTKRaceConfig::render, "Is rendering enabled?")
+        .def_readwrite("readback_buffers", &PySTKRaceConfig::readback_buffers, "Number of frames in flight for the asynchronous readback of render_data. RenderData of a step stays valid for readback_buffers-1 further steps.")
+        .def_readwrite("zero_copy", &PySTKRaceConfig::zero_copy, "Return render_data as read-only views into persistently mapped GPU buffers instead of copies. A view is overwritten readback_buffers steps after it was produced, copy it to keep it longer.")
+        .def_readwrite("color_format", &PySTKRaceConfig::color_format, "Format of render_data.image: RGB (uint8 H x W x 3), GRAY (uint8 H x W) or NONE (not read back)")
+        .def_readwrite("depth_format", &PySTKRaceConfig::depth_format, "Format of render_data.depth: FLOAT (raw depth buffer 0..1), UINT16 (raw depth scaled to 0..65535), LINEAR_FLOAT or LINEAR_HALF (float32 or float16 distance to the camera plane) or NONE (not read back)")
+        .def_readwrite("instance_format", &PySTKRaceConfig::instance_format, "Format of render_data.instance: ID (uint32 instance labels), OBJECT_TYPE (uint8 object type, i.e. instance >> pystk.object_type_shift) or NONE (not read back)")
+        .def_readwrite("observation_width", &PySTKRaceConfig::observation_width, "Width of render_data, resampled on the GPU (0: screen_width)")
+        .def_readwrite("observation_height", &PySTKRaceConfig::observation_height, "Height of render_data, resampled on the GPU (0: screen_height)")
+        .def_readwrite("frame_stack", &PySTKRaceConfig::frame_stack, "Number of frames stacked in render_data (oldest first). Values above 1 add a leading frame_stack dimension to image, depth and instance")
+        .def_readwrite("color_filter", &PySTKRaceConfig::color_filter, "Resampling filter for the image: AREA or NEAREST. Depth always uses NEAREST")
+        .def_readwrite("instance_filter", &PySTKRaceConfig::instance_filter, "Resampling filter for the instance labels: NEAREST or MODE (most frequent label)")
+        .def_readwrite("fast_restart", &PySTKRaceConfig::fast_restart, "Restart races by restoring a snapshot taken right after start instead of resetting the world (NORMAL_RACE and TIME_TRIAL only)")
+        .def_readwrite("physics_broadphase", &PySTKRaceConfig::physics_broadphase, "Broadphase of the physics world: AXIS_SWEEP (sweep and prune over the track bounds) or DBVT (dynamic AABB tree, scales better with many karts)")
+        .def_readwrite("physics_threads", &PySTKRaceConfig::physics_threads, "Number of threads that solve independent simulation islands (groups of touching karts and objects). With 1 thread the original sequential solver is used. 2 or more threads solve every island separately, which gives the same results for any number of threads >= 2, but slightly different trajectories than 1 thread. Results are only reproducible for a fixed choice of 1 or >= 2 threads")
+        .def_readwrite("physics_fps", &PySTKRaceConfig::physics_fps, "Ticks per second of the physics and game logic (0: the default of 120, otherwise 20..120). Lower rates simulate faster but less accurately, see the documentation")
+        .def_readwrite("physics_substeps", &PySTKRaceConfig::physics_substeps, "Number of physics steps per tick. More substeps simulate collisions and suspensions more accurately, at a cost per substep")
+        .def_readwrite("physics_solver_iterations", &PySTKRaceConfig::physics_solver_iterations, "Constraint solver iterations per physics step (0: the default of stk_config.xml). Fewer iterations are faster but let karts sink into each other and the track");
         add_pickle(cls);
     }
 
     {
         py::class_<PySTKRenderData, std::shared_ptr<PySTKRenderData> > cls(m, "RenderData", "SuperTuxKart rendering output");
         cls
-       .def_property_readonly("image", [](const PySTKRenderData & rd) { return rd.color_buf_->get(); }, "Color image of the kart (memoryview[uint8] screen_height x screen_width x 3)")
-       .def_property_readonly("depth", [](const PySTKRenderData & rd) { return rd.depth_buf_->get(); }, "Depth image of the kart (memoryview[float] screen_height x screen_width)")
-       .def_property_readonly("instance", [](const PySTKRenderData & rd) { return rd.instance_buf_->get(); }, "Instance labels (memoryview[uint32] screen_height x screen_width)");
+       .def_property_readonly("image", [](const PySTKRenderData & rd) -> py::object { if (rd.color_buf_) return rd.color_buf_->get(); return py::none(); }, "Color image of the kart (memoryview[uint8] screen_height x screen_width x 3, see RaceConfig.color_format)")
+       .def_property_readonly("depth", [](const PySTKRenderData & rd) -> py::object { if (rd.depth_buf_) return rd.depth_buf_->get(); return py::none(); }, "Depth image of the kart (memoryview[float] screen_height x screen_width, see RaceConfig.depth_format)")
+       .def_property_readonly("instance", [](const PySTKRenderData & rd) -> py::object { if (rd.instance_buf_) return rd.instance_buf_->get(); return py::none(); }, "Instance labels (memoryview[uint32] screen_height x screen_width, see RaceConfig.instance_format)")
+       .def_property_readonly("ready", &PySTKRenderData::ready, "Has the GPU finished transferring this frame? Accessing image, depth or instance before blocks until it has.");
 ;
 //        add_pickle(cls);
     }
@@ -178,32 +232,113 @@ PYBIND11_MODULE(pystk, m) {
         add_pickle(cls);
     }
     
+    {
+        py::class_<PySTKStepResult, std::shared_ptr<PySTKStepResult> > cls(m, "StepResult", "Summary of several steps taken at once. Evaluates to True while the race is running.");
+        cls
+        .def_readonly("finished", &PySTKStepResult::finished, "Has the race finished after each step (List[bool], at most repeat steps)")
+        .def_readonly("distance", &PySTKStepResult::distance, "Overall distance driven by each player during the steps (List[float], 0 outside of linear races)")
+        .def_readonly("collisions", &PySTKStepResult::collisions, "Number of collisions of each player with karts, the track or static objects during the steps (List[int])")
+        .def("__bool__", &PySTKStepResult::running);
+    }
+    
+    {
+        py::class_<PySTKRing, std::shared_ptr<PySTKRing> >(m, "ObservationRing", "Reads the observations a race in another process writes into a shared memory ring (see Race.attach_observation_ring)")
+        .def(py::init<const std::string &>(), py::arg("name"))
+        .def("get", [](std::shared_ptr<PySTKRing> r, float timeout) -> py::object {
+            const char * slot;
+            {
+                py::gil_scoped_release release;
+                slot = r->peek(timeout);
+            }
+            if (!slot) return py::none();
+            // Read-only views into the slot, they keep the ring mapped
+            auto * self = new std::shared_ptr<PySTKRing>(r);
+            py::capsule base(self, [](void * p) { delete static_cast<std::shared_ptr<PySTKRing>*>(p); });
+            py::dict d;
+            for(const auto & f: r->fields()) {
+                py::array a(py::dtype(f.dtype), std::vector<py::ssize_t>(f.shape, f.shape + f.ndim), slot + f.offset, base);
+                py::detail::array_proxy(a.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+                d[f.name] = a;
+            }
+            return d;
+        }, py::arg("timeout") = -1.f, "Wait up to timeout seconds (forever if negative) for the oldest unread observation, and return it as a dict of read-only numpy arrays. The arrays are views into the ring, they stay valid until release. Returns None on timeout or once the race closed the ring and all observations were read")
+        .def("release", &PySTKRing::release, "Hand the slot of the observation returned by get back to the race")
+        .def_property_readonly("name", &PySTKRing::name, "Name of the shared memory")
+        .def_property_readonly("num_slots", &PySTKRing::numSlots, "Number of slots")
+        .def_property_readonly("pending", &PySTKRing::pending, "Number of unread observations, num_slots means that the race waits for the reader")
+        .def_property_readonly("dropped", &PySTKRing::dropped, "Number of observations the race dropped since the ring was full for longer than its timeout")
+        .def_property_readonly("closed", &PySTKRing::closed, "Did the race close the ring");
+    }
+    
+    {
+        py::enum_<PySTKCollision::Type>(m, "CollisionType", "Type of a collision in Race.collisions")
+        .value("KART_KART", PySTKCollision::KART_KART)
+        .value("KART_TRACK", PySTKCollision::KART_TRACK)
+        .value("KART_OBJECT", PySTKCollision::KART_OBJECT)
+        .value("FLYABLE_KART", PySTKCollision::FLYABLE_KART)
+        .value("FLYABLE_TRACK", PySTKCollision::FLYABLE_TRACK)
+        .value("FLYABLE_OBJECT", PySTKCollision::FLYABLE_OBJECT)
+        .value("FLYABLE_FLYABLE", PySTKCollision::FLYABLE_FLYABLE);
+    }
+    
     m.def("is_running", &PySTKRace::isRunning,"Is a race running?");
     {
+        // Record dtype of PySTKCollision
+        py::dtype collision_dtype = py::dtype::from_args(py::dict(
+            "names"_a=py::make_tuple("type", "kart", "other", "location", "time"),
+            "formats"_a=py::make_tuple("u1", "<i4", "<i4", "(3,)<f4", "<f4"),
+            "offsets"_a=py::make_tuple(offsetof(PySTKCollision, type), offsetof(PySTKCollision, kart), offsetof(PySTKCollision, other), offsetof(PySTKCollision, location), offsetof(PySTKCollision, time)),
+            "itemsize"_a=sizeof(PySTKCollision)));
         py::class_<PySTKRace, std::shared_ptr<PySTKRace> >(m, "Race", "The SuperTuxKart race instance")
         .def(py::init<const PySTKRaceConfig &>(),py::arg("config"))
-        .def("restart", &PySTKRace::restart,"Restart the current track. Use this function if the race config does not change, instead of creating a new SuperTuxKart object")
-        .def("start", &PySTKRace::start,"start the race")
-        .def("step", (bool (PySTKRace::*)(const std::vector<PySTKAction> &)) &PySTKRace::step, py::arg("action"), "Take a step with an action per agent")
-        .def("step", (bool (PySTKRace::*)(const PySTKAction &)) &PySTKRace::step, py::arg("action"), "Take a step with an action for agent 0")
-        .def("step", (bool (PySTKRace::*)()) &PySTKRace::step, "Take a step without changing the action")
+        .def("restart", &PySTKRace::restart, py::call_guard<py::gil_scoped_release>(),"Restart the current track. Use this function if the race config does not change, instead of creating a new SuperTuxKart object")
+        .def("start", &PySTKRace::start, py::call_guard<py::gil_scoped_release>(),"start the race")
+        .def("save_state", [](const PySTKRace & r) {
+            std::string state;
+            {
+                py::gil_scoped_release release;
+                state = r.saveState();
+            }
+            return py::bytes(state);
+        }, "Snapshot the full simulation state (karts, physics, items, projectiles, laps and time) as a binary blob")
+        .def("load_state", [](PySTKRace & r, const py::bytes & state) {
+            const std::string s = state;
+            py::gil_scoped_release release;
+            r.loadState(s);
+        }, py::arg("state"), "Restore a snapshot taken with save_state on the same race. render_data is updated by the next step")
+        .def("step", (bool (PySTKRace::*)(const std::vector<PySTKAction> &)) &PySTKRace::step, py::arg("action"), py::call_guard<py::gil_scoped_release>(), "Take a step with an action per agent")
+        .def("step", (bool (PySTKRace::*)(const PySTKAction &)) &PySTKRace::step, py::arg("action"), py::call_guard<py::gil_scoped_release>(), "Take a step with an action for agent 0")
+        .def("step", (bool (PySTKRace::*)()) &PySTKRace::step, py::call_guard<py::gil_scoped_release>(), "Take a step without changing the action")
+        .def("step", (PySTKStepResult (PySTKRace::*)(const std::vector<PySTKAction> &, int, bool)) &PySTKRace::step, py::arg("action"), py::arg("repeat"), py::arg("render_last_only") = true, py::call_guard<py::gil_scoped_release>(), "Repeat an action per agent for repeat steps, stops early if the race finishes. Only renders the last step if render_last_only.")
+        .def("step", (PySTKStepResult (PySTKRace::*)(const PySTKAction &, int, bool)) &PySTKRace::step, py::arg("action"), py::arg("repeat"), py::arg("render_last_only") = true, py::call_guard<py::gil_scoped_release>(), "Repeat an action for agent 0 for repeat steps, stops early if the race finishes. Only renders the last step if render_last_only.")
+        .def("step", (PySTKStepResult (PySTKRace::*)(int, bool)) &PySTKRace::step, py::arg("repeat"), py::arg("render_last_only") = true, py::call_guard<py::gil_scoped_release>(), "Take repeat steps without changing the action")
         .def("stop", &PySTKRace::stop,"Stop the race")
+        .def("attach_observation_ring", &PySTKRace::attachRing, py::arg("name"), py::arg("num_slots") = 4, py::arg("timeout") = -1.f, py::call_guard<py::gil_scoped_release>(), "Create the shared memory ring name (e.g. '/pystk_env0'), every following step writes the render data of all players (image, depth, instance) and the player state (location, rotation, velocity, finished_laps, overall_distance, distance_down_track, done) into it. A step waits up to timeout seconds (forever if negative) while all num_slots slots are unread, and drops the observation after that. Other races keep stepping while it waits. Read the ring with ObservationRing in another process")
+        .def("detach_observation_ring", &PySTKRace::detachRing, py::call_guard<py::gil_scoped_release>(), "Close and remove the observation ring")
         .def_property_readonly("render_data", &PySTKRace::render_data, "rendering data from the last step")
         .def_property_readonly("last_action", &PySTKRace::last_action, "the last action the agent took")
+        .def_property_readonly("collisions", [collision_dtype](const PySTKRace & r) {
+            const auto & c = r.collisions();
+            return py::array(collision_dtype, {(py::ssize_t)c.size()}, {(py::ssize_t)sizeof(PySTKCollision)}, c.data());
+        }, "Collisions during the last step (or all steps of a repeated step), each pair of objects at most once per physics tick. A numpy record array with the fields type (CollisionType), kart (world kart id, for flyables the id of the owner), other (world kart id of the other kart or flyable owner, -1 for the track or objects), location (world coordinates) and time (race time)")
         .def_property_readonly("config", &PySTKRace::config,"The current race configuration");
     }
     
     m.def("list_tracks", &PySTKRace::listTracks, "Return a list of track names (possible values for RaceConfig.track)");
     m.def("list_karts", &PySTKRace::listKarts, "Return a list of karts to play as (possible values for PlayerConfig.kart");
+    m.def("set_track_cache_size", &PySTKRace::setTrackCacheSize, py::arg("size_mb"), py::call_guard<py::gil_scoped_release>(), "Keep the meshes of recently used tracks loaded between races, up to size_mb megabytes (0 disables the cache)");
+    m.def("track_cache_size", &PySTKRace::trackCacheSize, "Approximate memory used by the track cache in megabytes");
+    m.def("warm_texture_cache", &PySTKRace::warmTextureCache, "Load the textures of all karts and tracks, which fills the compressed texture cache for the current graphics config. The cache depends on high_definition_textures and max_texture_size, it requires texture_compression");
     
     // Initialize SuperTuxKart
     m.def("init", &path_and_init, py::arg("config"), "Initialize Python SuperTuxKart. Only call this function once per process. Calling it twice will cause a crash.");
+    m.def("preload", &path_and_preload, "Load all assets that do not need graphics (track and kart descriptions, characteristics) without creating a GL context. Worker processes forked after preload share this memory copy-on-write and only need to call init.");
     m.def("clean", &PySTKRace::clean, "Free Python SuperTuxKart, call this once at exit (optional). Will be called atexit otherwise.");
     
     auto atexit = py::module::import("atexit");
         atexit.attr("register")(py::cpp_function([]() {
             // A bit ugly
-            PySTKRace::running_kart = nullptr;
+            PySTKRace::running_races.clear();
             PySTKRace::clean();
         }));
 }
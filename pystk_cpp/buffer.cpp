@@ -1,7 +1,10 @@
 #include "buffer.hpp"
+#include "graphics/central_settings.hpp"
 #include "graphics/gl_headers.hpp"
 #include "utils/log.hpp"
 #include "util.hpp"
+#include <algorithm>
+#include <cstring>
 
 int n_channel(int format) {
     switch(format) {
@@ -33,28 +36,95 @@ int type_size(int format) {
     return 1;
 }
 
-BasicPBO::BasicPBO(int width, int height, int format, int type): width_(width), height_(height), format_(format), type_(type) {
-    size_ = width*height*n_channel(format)*type_size(type);
+// All PBOs that were not destroyed yet, numpy views can keep a PBO alive after its race
+static std::vector<BasicPBO *> live_pbos;
+
+BasicPBO::BasicPBO(int width, int height, int format, int type, bool persistent, int layers): width_(width), height_(height), layers_(layers), format_(format), type_(type) {
+    live_pbos.push_back(this);
+    size_ = width*height*layers*n_channel(format)*type_size(type);
     glGenBuffers(1, &buffer_id_);
     glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_id_);
-    glBufferData(GL_PIXEL_PACK_BUFFER, size_, NULL, GL_STREAM_COPY);
+    if (persistent && CVS->isARBBufferStorageUsable()) {
+        // Coherent mapping: everything the GPU wrote is visible once the fence signals
+        const GLbitfield flags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_PIXEL_PACK_BUFFER, size_, NULL, flags);
+        mapped_ = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size_, flags);
+        if (!mapped_)
+            Log::warn("buffer", "Failed to map the PBO persistently, falling back to copies.\n");
+    }
+    if (!mapped_)
+        glBufferData(GL_PIXEL_PACK_BUFFER, size_, NULL, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
-BasicPBO::~BasicPBO() {
+void BasicPBO::release() {
+    if (released_) return;
+    if (fence_)
+        glDeleteSync(fence_);
+    fence_ = nullptr;
+    if (mapped_) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_id_);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    }
+    mapped_ = nullptr;
     glDeleteBuffers(1, &buffer_id_);
+    released_ = true;
 }
-void BasicPBO::read(GLuint texture) {
+void BasicPBO::releaseAll() {
+    for(BasicPBO * pbo: live_pbos)
+        pbo->release();
+}
+BasicPBO::~BasicPBO() {
+    // Without a GL context (after releaseAll) there is nothing left to free
+    BasicPBO::release();
+    live_pbos.erase(std::find(live_pbos.begin(), live_pbos.end(), this));
+}
+void BasicPBO::read(GLuint texture, GLenum target) {
+    // A new read supersedes any transfer still in flight
+    if (fence_)
+        glDeleteSync(fence_);
     glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_id_);
     if (GLEW_VERSION_4_5) {
         glGetTextureImage(texture, 0, format_, type_, size_, 0);
     } else {
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glGetTexImage(GL_TEXTURE_2D, 0, format_, type_, 0);
+        glBindTexture(target, texture);
+        glGetTexImage(target, 0, format_, type_, 0);
+        glBindTexture(target, 0);
     }
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    fence_ = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+bool BasicPBO::ready() const {
+    if (!fence_) return true;
+    GLint status = GL_UNSIGNALED;
+    glGetSynciv(fence_, GL_SYNC_STATUS, sizeof(status), NULL, &status);
+    return status == GL_SIGNALED;
+}
+void BasicPBO::wait() {
+    if (!fence_) return;
+    // Flush once, then keep waiting in 1ms slices
+    GLenum r = glClientWaitSync(fence_, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    while (r == GL_TIMEOUT_EXPIRED)
+        r = glClientWaitSync(fence_, 0, 1000000);
+    if (r == GL_WAIT_FAILED)
+        Log::error("buffer", "glClientWaitSync failed, readback might be incomplete.\n");
+    glDeleteSync(fence_);
+    fence_ = nullptr;
 }
 void BasicPBO::write(void * mem) {
+    wait();
+    if (mapped_) {
+        memcpy(mem, mapped_, size_);
+        return;
+    }
     glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer_id_);
-    glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size_, mem);
+    void * ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size_, GL_MAP_READ_BIT);
+    if (ptr) {
+        memcpy(mem, ptr, size_);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else {
+        glGetBufferSubData(GL_PIXEL_PACK_BUFFER, 0, size_, mem);
+    }
     glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
@@ -68,35 +138,106 @@ py::array make(py::array::ShapeContainer shape, int gl_type) {
         case GL_SHORT:          return py::array_t<signed short, py::array::c_style>(shape);
         case GL_UNSIGNED_INT:   return py::array_t<unsigned int, py::array::c_style>(shape);
         case GL_INT:            return py::array_t<signed int, py::array::c_style>(shape);
+        case GL_HALF_FLOAT:     return py::array(py::dtype("float16"), shape);
         case GL_FLOAT:          return py::array_t<float, py::array::c_style>(shape);
     }
     Log::fatal("buffer", "Unsupported OpenGL type.\n");
     return py::array();
 }
 
-NumpyPBO::NumpyPBO(int width, int height, int format, int type): BasicPBO(width, height, format, type)
+const char * numpy_type(int gl_type) {
+    switch(gl_type) {
+        case GL_UNSIGNED_BYTE:  return "u1";
+        case GL_BYTE:           return "i1";
+        case GL_UNSIGNED_SHORT: return "u2";
+        case GL_SHORT:          return "i2";
+        case GL_UNSIGNED_INT:   return "u4";
+        case GL_INT:            return "i4";
+        case GL_HALF_FLOAT:     return "f2";
+        case GL_FLOAT:          return "f4";
+    }
+    Log::fatal("buffer", "Unsupported OpenGL type.\n");
+    return "";
+}
+
+NumpyPBO::NumpyPBO(int width, int height, int format, int type, bool flipped, bool persistent, int layers): BasicPBO(width, height, format, type, flipped && persistent, layers), flipped_(flipped)
 {
     py::array::ShapeContainer shape = {height, width};
+    if (layers > 1)
+        shape->insert(shape->begin(), layers);
     int c = n_channel(format);
     if (c > 1)
         shape->push_back(c);
     data_ = make(shape, type);
 }
 
-void NumpyPBO::read(unsigned int texture)
+void NumpyPBO::release()
+{
+    if (released_) return;
+    if (mapped_) {
+        wait();
+        // The views must not point into the mapping once it is gone, they
+        // (and get) use a copy of the last frame in data_ from now on
+        memcpy(data_.mutable_data(), mapped_, size_);
+        for (const py::weakref & w: views_) {
+            py::object view = w();
+            if (!view.is_none())
+                py::detail::array_proxy(view.ptr())->data = static_cast<char*>(data_.mutable_data());
+        }
+        views_.clear();
+    }
+    need_update_ = false;
+    BasicPBO::release();
+}
+
+void NumpyPBO::read(unsigned int texture, unsigned int target)
 {
-    BasicPBO::read(texture);
+    BasicPBO::read(texture, target);
     need_update_ = true;
 }
 
+void NumpyPBO::yflip(void * mem) const
+{
+    const int layer_size = size_ / layers_;
+    for (int l = 0; l < layers_; l++)
+        _yflip(static_cast<char*>(mem) + l * layer_size, height_, layer_size / height_);
+}
+
+void NumpyPBO::copy(void * mem)
+{
+    BasicPBO::write(mem);
+    if (!flipped_)
+        yflip(mem);
+}
+
+std::vector<int> NumpyPBO::shape() const
+{
+    return std::vector<int>(data_.shape(), data_.shape() + data_.ndim());
+}
+
 py::array NumpyPBO::get()
 {
+    if (mapped_) {
+        wait();
+        // A read-only view straight into the mapped PBO. The view keeps the PBO
+        // alive, its content changes once the PBO is reused for a new frame.
+        auto * self = new std::shared_ptr<NumpyPBO>(shared_from_this());
+        py::capsule base(self, [](void * p) { delete static_cast<std::shared_ptr<NumpyPBO>*>(p); });
+        py::array view(data_.dtype(), py::array::ShapeContainer(data_.shape(), data_.shape() + data_.ndim()),
+                       py::array::StridesContainer(data_.strides(), data_.strides() + data_.ndim()), mapped_, base);
+        py::detail::array_proxy(view.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+        views_.erase(std::remove_if(views_.begin(), views_.end(), [](const py::weakref & w) { return w().is_none(); }), views_.end());
+        views_.push_back(py::weakref(view));
+        return view;
+    }
     if (need_update_) {
         // Copy data_ here to preveny any nasty surprises...
         data_ = make(py::array::ShapeContainer(data_.shape(), data_.shape() + data_.ndim()), type_);
         BasicPBO::write(data_.mutable_data());
-        _yflip(data_.mutable_data(), data_.shape()[0], data_.strides()[0]);
+        // Some textures are flipped on the GPU already
+        if (!flipped_)
+            yflip(data_.mutable_data());
+        need_update_ = false;
     }
     return data_;
 }
-
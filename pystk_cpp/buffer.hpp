@@ -1,26 +1,68 @@
 #pragma once
+#include <memory>
+#include <vector>
 #include <pybind11/numpy.h>
 namespace py = pybind11;
 
+struct __GLsync;
+
 class BasicPBO {
 protected:
     unsigned int buffer_id_;
-    int width_, height_, format_, type_, size_;
+    int width_, height_, layers_, format_, type_, size_;
+    __GLsync * fence_ = nullptr;
+    // Persistently mapped memory of the PBO (if any)
+    void * mapped_ = nullptr;
+    // The GL objects were freed by release (the PBO might outlive the GL context)
+    bool released_ = false;
     BasicPBO(BasicPBO&) = delete;
     BasicPBO& operator=(BasicPBO&) = delete;
 public:
-    BasicPBO(int width, int height, int format, int type);
-    virtual void read(unsigned int texture);
+    // layers: Number of layers of a texture array (1 for regular textures)
+    BasicPBO(int width, int height, int format, int type, bool persistent=false, int layers=1);
+    // Queue an asynchronous copy of texture into the PBO, guarded by a fence
+    // target is GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+    virtual void read(unsigned int texture, unsigned int target);
+    // Copy the PBO into mem, blocks until the fence signals
     virtual void write(void * mem);
+    // Has the last read finished? Never blocks.
+    bool ready() const;
+    // Block until the last read finished
+    void wait();
+    bool isPersistent() const { return mapped_ != nullptr; }
+    // Size of the PBO in bytes
+    int size() const { return size_; }
+    int type() const { return type_; }
+    // Free the GL objects, the PBO cannot read anymore afterwards
+    virtual void release();
+    // Release all PBOs, call this before the GL context is destroyed
+    static void releaseAll();
     virtual ~BasicPBO();
 };
 
-class NumpyPBO: public BasicPBO {
+class NumpyPBO: public BasicPBO, public std::enable_shared_from_this<NumpyPBO> {
 protected:
-    bool need_update_;
+    bool need_update_ = false, flipped_ = false;
     py::array data_;
+    // Views returned by get that point into the mapped PBO
+    std::vector<py::weakref> views_;
+    // Flip every layer of the image in mem (size_ bytes) upside down
+    void yflip(void * mem) const;
 public:
-    NumpyPBO(int width, int height, int format, int type);
-    virtual void read(unsigned int texture);
+    // flipped: The texture is already flipped on the GPU (top row first)
+    // persistent: get returns a read-only view into the (persistently mapped)
+    //             PBO if possible, requires a flipped texture
+    // layers: Texture arrays with more than one layer are returned as layers x height x width (x channels)
+    NumpyPBO(int width, int height, int format, int type, bool flipped=false, bool persistent=false, int layers=1);
+    virtual void read(unsigned int texture, unsigned int target);
+    // Views into the mapped PBO keep the last frame as a copy
+    virtual void release();
     virtual py::array get();
+    // Copy the image (top row first) into mem, does not touch any python object
+    void copy(void * mem);
+    // Shape of the array returned by get
+    std::vector<int> shape() const;
 };
+
+// numpy type string (e.g. "u1") of an OpenGL type
+const char * numpy_type(int gl_type);
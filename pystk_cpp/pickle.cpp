@@ -29,6 +29,8 @@ void pickle(std::ostream & s, const PySTKGraphicsConfig & o) {
     pickle(s, o.ssao);
     pickle(s, o.degraded_IBL);
     pickle(s, o.high_definition_textures);
+    pickle(s, o.render);
+    pickle(s, o.max_texture_size);
 }
 void unpickle(std::istream & s, PySTKGraphicsConfig * o) {
     unpickle(s, &o->screen_width);
@@ -46,6 +48,8 @@ void unpickle(std::istream & s, PySTKGraphicsConfig * o) {
     unpickle(s, &o->ssao);
     unpickle(s, &o->degraded_IBL);
     unpickle(s, &o->high_definition_textures);
+    unpickle(s, &o->render);
+    unpickle(s, &o->max_texture_size);
 }
 void pickle(std::ostream & s, const PySTKPlayerConfig & o) {
     pickle(s, o.kart);
@@ -64,6 +68,22 @@ void pickle(std::ostream & s, const PySTKRaceConfig & o) {
     pickle(s, o.seed);
     pickle(s, o.num_kart);
     pickle(s, o.step_size);
+    pickle(s, o.readback_buffers);
+    pickle(s, o.zero_copy);
+    pickle(s, o.color_format);
+    pickle(s, o.depth_format);
+    pickle(s, o.instance_format);
+    pickle(s, o.observation_width);
+    pickle(s, o.observation_height);
+    pickle(s, o.frame_stack);
+    pickle(s, o.color_filter);
+    pickle(s, o.instance_filter);
+    pickle(s, o.fast_restart);
+    pickle(s, o.physics_broadphase);
+    pickle(s, o.physics_threads);
+    pickle(s, o.physics_fps);
+    pickle(s, o.physics_substeps);
+    pickle(s, o.physics_solver_iterations);
 }
 void unpickle(std::istream & s, PySTKRaceConfig * o) {
     unpickle(s, &o->difficulty);
@@ -74,6 +94,22 @@ void unpickle(std::istream & s, PySTKRaceConfig * o) {
     unpickle(s, &o->seed);
     unpickle(s, &o->num_kart);
     unpickle(s, &o->step_size);
+    unpickle(s, &o->readback_buffers);
+    unpickle(s, &o->zero_copy);
+    unpickle(s, &o->color_format);
+    unpickle(s, &o->depth_format);
+    unpickle(s, &o->instance_format);
+    unpickle(s, &o->observation_width);
+    unpickle(s, &o->observation_height);
+    unpickle(s, &o->frame_stack);
+    unpickle(s, &o->color_filter);
+    unpickle(s, &o->instance_filter);
+    unpickle(s, &o->fast_restart);
+    unpickle(s, &o->physics_broadphase);
+    unpickle(s, &o->physics_threads);
+    unpickle(s, &o->physics_fps);
+    unpickle(s, &o->physics_substeps);
+    unpickle(s, &o->physics_solver_iterations);
 }
 void pickle(std::ostream & s, const PySTKAction & o) {
     pickle(s, o.steering_angle);
@@ -53,6 +53,7 @@
 #include "graphics/graphics_restrictions.hpp"
 #include "graphics/irr_driver.hpp"
 #include "graphics/material_manager.hpp"
+#include "graphics/observation_stage.hpp"
 #include "graphics/particle_kind_manager.hpp"
 #include "graphics/referee.hpp"
 #include "graphics/render_target.hpp"
@@ -72,11 +73,15 @@
 #include "karts/kart_model.hpp"
 #include "karts/kart_properties.hpp"
 #include "karts/kart_properties_manager.hpp"
+#include "modes/linear_world.hpp"
 #include "modes/world.hpp"
+#include "physics/physics.hpp"
+#include "race/race_context.hpp"
 #include "race/race_manager.hpp"
 #include "scriptengine/property_animator.hpp"
 #include "tracks/arena_graph.hpp"
 #include "tracks/track.hpp"
+#include "tracks/track_cache.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/command_line.hpp"
 #include "utils/constants.hpp"
@@ -85,10 +90,12 @@
 #include "utils/log.hpp"
 #include "utils/mini_glm.hpp"
 #include "utils/profiler.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/objecttype.h"
 #include "util.hpp"
 #include "buffer.hpp"
+#include "shm_ring.hpp"
 
 #ifdef RENDERDOC
 #include "renderdoc_app.h"
@@ -141,54 +148,141 @@ const PySTKGraphicsConfig & PySTKGraphicsConfig::ld() {
     };
     return config;
 }
+const PySTKGraphicsConfig & PySTKGraphicsConfig::none() {
+    static PySTKGraphicsConfig config = {600,400,
+        false, false, false, false, false,
+        0,     // particle_effects
+        false, // animated_characters
+        false, // motionblur
+        false, // mlaa
+        false, // texture_compression
+        false, // ssao
+        false, // degraded_IBL
+        0,     // high_definition_textures
+        false, // render
+    };
+    return config;
+}
 
 class PySTKRenderTarget {
     friend class PySTKRace;
 
 private:
-    const int BUF_SIZE = 2;
     std::unique_ptr<RenderTarget> rt_;
     std::vector<std::shared_ptr<NumpyPBO> > color_buf_, depth_buf_, instance_buf_;
     int buf_num_=0;
+    // Converts and flips the observations on the GPU (unless the default raw output is read)
+    std::unique_ptr<ObservationStage> stage_;
 
 protected:
     void render(irr::scene::ICameraSceneNode* camera, float dt);
     void fetch(std::shared_ptr<PySTKRenderData> data);
+    // Drops the stacked frames of the previous race
+    void reset();
     
 public:
-    PySTKRenderTarget(std::unique_ptr<RenderTarget>&& rt);
+    PySTKRenderTarget(std::unique_ptr<RenderTarget>&& rt, const PySTKRaceConfig & config);
     
 };
 
-PySTKRenderTarget::PySTKRenderTarget(std::unique_ptr<RenderTarget>&& rt):rt_(std::move(rt)) {
+static ObservationStage::ColorOutput translate_color(PySTKRaceConfig::ColorFormat f) {
+    switch (f) {
+        case PySTKRaceConfig::COLOR_RGB: return ObservationStage::COLOR_RGB;
+        case PySTKRaceConfig::COLOR_GRAY: return ObservationStage::COLOR_GRAY;
+        case PySTKRaceConfig::COLOR_NONE: return ObservationStage::COLOR_NONE;
+    }
+    return ObservationStage::COLOR_RGB;
+}
+static ObservationStage::DepthOutput translate_depth(PySTKRaceConfig::DepthFormat f) {
+    switch (f) {
+        case PySTKRaceConfig::DEPTH_FLOAT: return ObservationStage::DEPTH_RAW;
+        case PySTKRaceConfig::DEPTH_UINT16: return ObservationStage::DEPTH_RAW_UINT16;
+        case PySTKRaceConfig::DEPTH_LINEAR_FLOAT: return ObservationStage::DEPTH_LINEAR;
+        case PySTKRaceConfig::DEPTH_LINEAR_HALF: return ObservationStage::DEPTH_LINEAR_HALF;
+        case PySTKRaceConfig::DEPTH_NONE: return ObservationStage::DEPTH_NONE;
+    }
+    return ObservationStage::DEPTH_RAW;
+}
+static ObservationStage::LabelOutput translate_instance(PySTKRaceConfig::InstanceFormat f) {
+    switch (f) {
+        case PySTKRaceConfig::INSTANCE_ID: return ObservationStage::LABEL_INSTANCE;
+        case PySTKRaceConfig::INSTANCE_OBJECT_TYPE: return ObservationStage::LABEL_OBJECT_TYPE;
+        case PySTKRaceConfig::INSTANCE_NONE: return ObservationStage::LABEL_NONE;
+    }
+    return ObservationStage::LABEL_INSTANCE;
+}
+
+static ObservationStage::Filter translate_filter(PySTKRaceConfig::Filter f) {
+    switch (f) {
+        case PySTKRaceConfig::NEAREST: return ObservationStage::FILTER_NEAREST;
+        case PySTKRaceConfig::AREA: return ObservationStage::FILTER_AREA;
+        case PySTKRaceConfig::MODE: return ObservationStage::FILTER_MODE;
+    }
+    return ObservationStage::FILTER_NEAREST;
+}
+
+PySTKRenderTarget::PySTKRenderTarget(std::unique_ptr<RenderTarget>&& rt, const PySTKRaceConfig & config):rt_(std::move(rt)) {
     int W = rt_->getTextureSize().Width, H = rt_->getTextureSize().Height;
+    int OW = config.observation_width > 0 ? config.observation_width : W;
+    int OH = config.observation_height > 0 ? config.observation_height : H;
+    int K = std::max(config.frame_stack, 1);
     buf_num_ = 0;
-    for(int i=0; i<BUF_SIZE; i++) {
-        color_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_RGB, GL_UNSIGNED_BYTE));
-        depth_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_DEPTH_COMPONENT, GL_FLOAT));
-        instance_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_RED_INTEGER, GL_UNSIGNED_INT));
+    bool use_stage = config.zero_copy || config.color_format != PySTKRaceConfig::COLOR_RGB ||
+                     config.depth_format != PySTKRaceConfig::DEPTH_FLOAT || config.instance_format != PySTKRaceConfig::INSTANCE_ID ||
+                     OW != W || OH != H || K > 1;
+    if (use_stage && rt_->getRTTs())
+        stage_.reset(new ObservationStage(OW, OH, K, translate_color(config.color_format), translate_depth(config.depth_format), translate_instance(config.instance_format),
+                                          translate_filter(config.color_filter), translate_filter(config.instance_filter)));
+    for(int i=0; i<std::max(config.readback_buffers, 1); i++) {
+        if (stage_) {
+            // Read the converted outputs, they are flipped already
+            const ObservationStage::Output * out[3] = {&stage_->getColor(), &stage_->getDepth(), &stage_->getLabel()};
+            std::vector<std::shared_ptr<NumpyPBO> > * buf[3] = {&color_buf_, &depth_buf_, &instance_buf_};
+            for(int k=0; k<3; k++)
+                buf[k]->push_back(out[k]->enabled() ? std::make_shared<NumpyPBO>(OW, OH, out[k]->m_format, out[k]->m_type, true, config.zero_copy, K) : nullptr);
+        } else {
+            color_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_RGB, GL_UNSIGNED_BYTE));
+            depth_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_DEPTH_COMPONENT, GL_FLOAT));
+            instance_buf_.push_back(std::make_shared<NumpyPBO>(W, H, GL_RED_INTEGER, GL_UNSIGNED_INT));
+        }
     }
 }
 void PySTKRenderTarget::render(irr::scene::ICameraSceneNode* camera, float dt) {
     rt_->renderToTexture(camera, dt);
+    RTT * rtts = rt_->getRTTs();
+    if (stage_ && rtts)
+        stage_->process(rtts, camera);
 }
 void PySTKRenderTarget::fetch(std::shared_ptr<PySTKRenderData> data) {
     RTT * rtts = rt_->getRTTs();
     if (rtts && data) {
-        unsigned int W = rtts->getWidth(), H = rtts->getHeight();
-        // Read the color and depth image
+        // Queue the color and depth image readback, it completes asynchronously
         data->color_buf_ = color_buf_[buf_num_];
         data->depth_buf_ = depth_buf_[buf_num_];
         data->instance_buf_ = instance_buf_[buf_num_];
         
-        data->depth_buf_->read(rtts->getDepthStencilTexture());
-        data->color_buf_->read(rtts->getRenderTarget(RTT_COLOR));
-        data->instance_buf_->read(rtts->getRenderTarget(RTT_LABEL));
-        buf_num_ = (buf_num_+1) % BUF_SIZE;
+        if (stage_) {
+            if (data->depth_buf_) data->depth_buf_->read(stage_->getDepth().getTexture(), GL_TEXTURE_2D_ARRAY);
+            if (data->color_buf_) data->color_buf_->read(stage_->getColor().getTexture(), GL_TEXTURE_2D_ARRAY);
+            if (data->instance_buf_) data->instance_buf_->read(stage_->getLabel().getTexture(), GL_TEXTURE_2D_ARRAY);
+        } else {
+            data->depth_buf_->read(rtts->getDepthStencilTexture(), GL_TEXTURE_2D);
+            data->color_buf_->read(rtts->getRenderTarget(RTT_COLOR), GL_TEXTURE_2D);
+            data->instance_buf_->read(rtts->getRenderTarget(RTT_LABEL), GL_TEXTURE_2D);
+        }
+        buf_num_ = (buf_num_+1) % color_buf_.size();
     }
     
 }
 
+void PySTKRenderTarget::reset() {
+    if (stage_)
+        stage_->clear();
+}
+
+bool PySTKRenderData::ready() const {
+    return (!color_buf_ || color_buf_->ready()) && (!depth_buf_ || depth_buf_->ready()) && (!instance_buf_ || instance_buf_->ready());
+}
 
 void PySTKAction::set(KartControl * control) const {
     control->setAccel(acceleration);
@@ -209,22 +303,25 @@ void PySTKAction::get(const KartControl * control) {
     drift = control->getSkidControl() != KartControl::SC_NONE;
 }
 
-PySTKRace * PySTKRace::running_kart = 0;
+std::vector<PySTKRace *> PySTKRace::running_races;
 static int is_init = 0;
+// All assets that do not need graphics are loaded (see preload)
+static bool is_preloaded = false;
 #ifdef RENDERDOC
 static RENDERDOC_API_1_1_2 *rdoc_api = NULL;
 #endif
 void PySTKRace::init(const PySTKGraphicsConfig & config) {
-    if (running_kart)
+    if (running_races.size())
         throw std::invalid_argument("Cannot init while supertuxkart is running!");
     if (is_init) {
         throw std::invalid_argument("PySTK already initialized! Call clean first!");
     } else {
+        if (!is_preloaded)
+            loadAssets(&config);
         is_init = 1;
-        initUserConfig();
-        stk_config->load(file_manager->getAsset("stk_config.xml"));
+        is_preloaded = false;
         initGraphicsConfig(config);
-        initRest();
+        initGraphics();
         load();
     }
 #ifdef RENDERDOC
@@ -248,32 +345,92 @@ void PySTKRace::init(const PySTKGraphicsConfig & config) {
 
 #endif
 }
+void PySTKRace::preload() {
+    if (is_init)
+        throw std::invalid_argument("PySTK already initialized! Call preload before init.");
+    if (is_preloaded)
+        return;
+    loadAssets(nullptr);
+    is_preloaded = true;
+}
+void PySTKRace::loadAssets(const PySTKGraphicsConfig * config) {
+    initUserConfig();
+    stk_config->load(file_manager->getAsset("stk_config.xml"));
+    // The settings are in place before anything is loaded. preload does not
+    // know the graphics config yet and loads as without graphics, init
+    // applies the actual config afterwards.
+    initGraphicsConfig(config ? *config : PySTKGraphicsConfig::none());
+    initAssets();
+}
 void PySTKRace::clean() {
-    if (running_kart)
+    if (running_races.size())
         throw std::invalid_argument("Cannot clean up while supertuxkart is running!");
-    if (is_init) {
+    if (is_init || is_preloaded) {
+        // numpy arrays can keep render data alive, free its GL buffers while the context exists
+        if (is_init)
+            BasicPBO::releaseAll();
         cleanSuperTuxKart();
         Log::flushBuffers();
 
         delete file_manager;
         file_manager = NULL;
         is_init = 0;
+        is_preloaded = false;
     }
 }
-bool PySTKRace::isRunning() { return running_kart; }
+bool PySTKRace::isRunning() { return running_races.size(); }
+std::unique_lock<std::recursive_mutex> PySTKRace::activate(const PySTKRace * race) {
+    std::unique_lock<std::recursive_mutex> lock(RaceContext::getLock());
+    if (race && race->context_)
+        race->context_->activate();
+    return lock;
+}
+std::unique_lock<std::recursive_mutex> PySTKRace::activateReleaseGIL(const PySTKRace * race) {
+    pybind11::gil_scoped_release release;
+    return activate(race);
+}
 PySTKRace::PySTKRace(const PySTKRaceConfig & config) {
-    if (running_kart)
-        throw std::invalid_argument("Cannot run more than one supertux instance per process!");
+    // The render targets allocate numpy arrays, which needs the GIL
+    auto lock = activateReleaseGIL(nullptr);
+    // All races share one scene graph, only a single race can render
+    for(const PySTKRace * r: running_races)
+        if (config.render || r->config_.render)
+            throw std::invalid_argument("Only races with render=False can run alongside other races in one process!");
     if (!is_init)
         throw std::invalid_argument("PySTK not initialized yet! Call pystk.init().");
-    running_kart = this;
-    
-    resetObjectId();
-    
-    setupConfig(config);
-    for(int i=0; i<config.players.size(); i++)
-        render_targets_.push_back( std::make_unique<PySTKRenderTarget>(irr_driver->createRenderTarget( {(unsigned int)UserConfigParams::m_width, (unsigned int)UserConfigParams::m_height}, "player"+std::to_string(i))) );
+    if (config.render && CVS->isNoGraphics())
+        throw std::invalid_argument("Cannot render, pystk was initialized without graphics! Use render=False.");
+    if (config.color_filter == PySTKRaceConfig::MODE)
+        throw std::invalid_argument("color_filter has to be NEAREST or AREA!");
+    if (config.instance_filter == PySTKRaceConfig::AREA)
+        throw std::invalid_argument("instance_filter has to be NEAREST or MODE!");
+    if (config.physics_threads < 1)
+        throw std::invalid_argument("physics_threads has to be at least 1!");
+    // Some timers are stored in 8 bit ticks, they overflow at higher rates
+    const int max_fps = stk_config->getDefaultPhysicsFPS();
+    if (config.physics_fps != 0 && (config.physics_fps < 20 || config.physics_fps > max_fps))
+        throw std::invalid_argument("physics_fps has to be 0 (default) or between 20 and "+std::to_string(max_fps)+"!");
+    if (config.physics_substeps < 1)
+        throw std::invalid_argument("physics_substeps has to be at least 1!");
+    if (config.physics_solver_iterations < 0)
+        throw std::invalid_argument("physics_solver_iterations cannot be negative!");
+    context_.reset(new RaceContext());
+    context_->activate();
     
+    try {
+        resetObjectId();
+        
+        setupConfig(config);
+        for(int i=0; i<config.players.size() && config.render; i++)
+            render_targets_.push_back( std::make_unique<PySTKRenderTarget>(irr_driver->createRenderTarget( {(unsigned int)UserConfigParams::m_width, (unsigned int)UserConfigParams::m_height}, "player"+std::to_string(i)), config) );
+    } catch (...) {
+        // The destructor does not run, free the half built race like it does
+        render_targets_.clear();
+        context_.reset();
+        throw;
+    }
+    // Only register the race once nothing can throw anymore
+    running_races.push_back(this);
 }
 std::vector<std::string> PySTKRace::listTracks() {
     if (track_manager)
@@ -285,8 +442,56 @@ std::vector<std::string> PySTKRace::listKarts() {
         return kart_properties_manager->getAllAvailableKarts();
     return std::vector<std::string>();
 }
+void PySTKRace::setTrackCacheSize(float size_mb) {
+    if (size_mb < 0)
+        throw std::invalid_argument("The track cache size cannot be negative!");
+    auto lock = activate(nullptr);
+    TrackCache::setBudget((size_t)(size_mb * 1024 * 1024));
+}
+float PySTKRace::trackCacheSize() {
+    return TrackCache::getSize() / (1024.f * 1024.f);
+}
+void PySTKRace::warmTextureCache() {
+    if (!is_init)
+        throw std::invalid_argument("PySTK not initialized yet! Call pystk.init().");
+    if (CVS->isNoGraphics())
+        throw std::invalid_argument("Cannot load textures, pystk was initialized without graphics!");
+    // Only compressed textures are cached
+    if (!CVS->isTextureCompressionEnabled())
+        throw std::invalid_argument("Texture compression is disabled (or not supported), there is no texture cache to fill!");
+    // Hold the lock for all races below, they create numpy arrays and need the GIL
+    auto lock = activateReleaseGIL(nullptr);
+    for (const std::string & kart: listKarts())
+        kart_properties_manager->loadKartModels(kart);
+    // Loading a track compresses and caches all its textures
+    for (const std::string & ident: listTracks()) {
+        const Track * track = track_manager->getTrack(ident);
+        if (!track || track->isInternal())
+            continue;
+        PySTKRaceConfig config;
+        config.track = ident;
+        config.render = false;
+        if (track->isSoccer())
+            config.mode = PySTKRaceConfig::SOCCER;
+        else if (track->isArena())
+            config.mode = PySTKRaceConfig::THREE_STRIKES;
+        PySTKRace race(config);
+        race.start();
+        race.stop();
+    }
+}
 PySTKRace::~PySTKRace() {
-    running_kart = nullptr;
+    auto lock = activateReleaseGIL(nullptr);
+    running_races.erase(std::find(running_races.begin(), running_races.end(), this));
+    if (is_init) {
+        context_->activate();
+        render_targets_.clear();
+        // Deletes the world of this race
+        context_.reset();
+    } else {
+        // Everything was freed by clean already
+        context_.release();
+    }
 }
 
 class LocalPlayerAIController: public Controller {
@@ -341,12 +546,184 @@ public:
     { return ai_controller_->finishedRace(time); }
 };
 void PySTKRace::restart() {
-    World::getWorld()->reset(true /* restart */);
+    auto lock = activate(this);
+    if (!start_state_.empty()) {
+        // Restoring the snapshot replaces World::reset. The track is reset
+        // first: the enabled state of track objects, their animations and
+        // the startup script are not part of a snapshot. Items, checklines
+        // and physical objects are restored from the snapshot afterwards.
+        Track::getCurrentTrack()->reset();
+        loadState(start_state_);
+        World * world = World::getWorld();
+        for(unsigned int i=0; i<world->getNumKarts(); i++)
+            world->getKart(i)->getController()->reset();
+        Camera::resetAllCameras();
+    } else {
+        World::getWorld()->reset(true /* restart */);
+    }
     ItemManager::updateRandomSeed(config_.seed);
     powerup_manager->setRandomSeed(config_.seed);
+    for(auto & rt: render_targets_)
+        rt->reset();
 }
 
+// Location (3), rotation (4), velocity (3), finished laps, overall distance and distance down track of a player kart
+static void player_state(const AbstractKart * kart, const LinearWorld * lw, float * location, float * rotation, float * velocity,
+                         int * finished_laps, float * overall_distance, float * distance_down_track) {
+    const Vec3 & xyz = kart->getXYZ();
+    const Vec3 v = kart->getVelocity();
+    const btQuaternion & q = kart->getRotation();
+    for(int d=0; d<3; d++) {
+        location[d] = xyz[d];
+        velocity[d] = v[d];
+    }
+    rotation[0] = q.x(); rotation[1] = q.y(); rotation[2] = q.z(); rotation[3] = q.w();
+    const int id = kart->getWorldKartId();
+    *finished_laps = lw ? lw->getFinishedLapsOfKart(id) : 0;
+    *overall_distance = lw ? lw->getOverallDistance(id) : 0;
+    *distance_down_track = lw ? lw->getDistanceDownTrackForKart(id, true) : 0;
+}
+static PySTKRingField ring_field(const std::string & name, const char * dtype, const std::vector<int> & shape, uint64_t size) {
+    PySTKRingField f = {};
+    strncpy(f.name, name.c_str(), sizeof(f.name) - 1);
+    strncpy(f.dtype, dtype, sizeof(f.dtype) - 1);
+    f.ndim = shape.size();
+    for(int i=0; i<f.ndim; i++)
+        f.shape[i] = shape[i];
+    f.size = size;
+    return f;
+}
+void PySTKRace::attachRing(const std::string & name, int num_slots, float timeout) {
+    auto lock = activate(this);
+    const int n = config_.players.size();
+    std::vector<PySTKRingField> fields;
+    // The images of all players are stacked (all render targets have the same size)
+    if (render_targets_.size()) {
+        const PySTKRenderTarget & rt = *render_targets_[0];
+        const std::shared_ptr<NumpyPBO> bufs[3] = {rt.color_buf_[0], rt.depth_buf_[0], rt.instance_buf_[0]};
+        const char * names[3] = {"image", "depth", "instance"};
+        for(int k=0; k<3; k++)
+            if (bufs[k]) {
+                std::vector<int> shape = bufs[k]->shape();
+                shape.insert(shape.begin(), n);
+                fields.push_back(ring_field(names[k], numpy_type(bufs[k]->type()), shape, (uint64_t)n * bufs[k]->size()));
+            }
+    }
+    fields.push_back(ring_field("location", "f4", {n, 3}, n * 3 * sizeof(float)));
+    fields.push_back(ring_field("rotation", "f4", {n, 4}, n * 4 * sizeof(float)));
+    fields.push_back(ring_field("velocity", "f4", {n, 3}, n * 3 * sizeof(float)));
+    fields.push_back(ring_field("finished_laps", "i4", {n}, n * sizeof(int)));
+    fields.push_back(ring_field("overall_distance", "f4", {n}, n * sizeof(float)));
+    fields.push_back(ring_field("distance_down_track", "f4", {n}, n * sizeof(float)));
+    fields.push_back(ring_field("done", "u1", {1}, 1));
+    ring_timeout_ = timeout;
+    std::atomic_store(&ring_, std::make_shared<PySTKRing>(name, fields, num_slots));
+}
+void PySTKRace::detachRing() {
+    auto lock = activate(this);
+    std::atomic_store(&ring_, std::shared_ptr<PySTKRing>());
+}
+void PySTKRace::waitRing() const {
+    // Waiting with the lock would stop all other races (and detachRing) until
+    // the reader frees a slot. This race is the only producer, the slot stays
+    // free until writeRing.
+    std::shared_ptr<PySTKRing> ring = std::atomic_load(&ring_);
+    if (ring)
+        ring->wait(ring_timeout_);
+}
+void PySTKRace::writeRing(bool finished) {
+    // waitRing waited for the slot already
+    char * slot = ring_->acquire(0);
+    if (!slot) {
+        // The consumer did not free a slot in time
+        ring_->drop();
+        return;
+    }
+    const std::vector<PySTKRingField> fields = ring_->fields();
+    auto field = [&](const char * name) -> char * {
+        for(const auto & f: fields)
+            if (!strcmp(f.name, name)) return slot + f.offset;
+        return nullptr;
+    };
+    const char * names[3] = {"image", "depth", "instance"};
+    for(int k=0; k<3; k++)
+        for(const auto & f: fields)
+            if (!strcmp(f.name, names[k])) {
+                const uint64_t size = f.size / config_.players.size();
+                for(int i=0; i<config_.players.size(); i++) {
+                    const PySTKRenderData * data = i < render_data_.size() ? render_data_[i].get() : nullptr;
+                    const std::shared_ptr<NumpyPBO> buf = data ? (k == 0 ? data->color_buf_ : k == 1 ? data->depth_buf_ : data->instance_buf_) : nullptr;
+                    // Players without render data (no frame rendered yet) get zeros, not the old content of the slot
+                    if (buf)
+                        buf->copy(slot + f.offset + i * size);
+                    else
+                        memset(slot + f.offset + i * size, 0, size);
+                }
+            }
+    World * world = World::getWorld();
+    const LinearWorld * lw = dynamic_cast<LinearWorld*>(world);
+    float * location = (float*)field("location"), * rotation = (float*)field("rotation"), * velocity = (float*)field("velocity");
+    float * overall_distance = (float*)field("overall_distance"), * distance_down_track = (float*)field("distance_down_track");
+    int * finished_laps = (int*)field("finished_laps");
+    for(int i=0; i<config_.players.size(); i++)
+        player_state(world->getPlayerKart(i), lw, location+3*i, rotation+4*i, velocity+3*i, finished_laps+i, overall_distance+i, distance_down_track+i);
+    *(uint8_t*)field("done") = finished;
+    ring_->commit();
+}
+
+// Every snapshot starts with this header, such that a truncated snapshot or
+// one of another pystk version is rejected before the world is touched
+static const uint32_t SNAPSHOT_MAGIC = 0x4b545350; // "PSTK"
+static const uint32_t SNAPSHOT_VERSION = 1;
+static const size_t SNAPSHOT_HEADER_SIZE = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+std::string PySTKRace::saveState() const {
+    auto lock = activate(this);
+    World * world = World::getWorld();
+    if (!world) throw std::invalid_argument("save_state requires a running race");
+    Snapshot body;
+    body.add(time_leftover_);
+    world->saveState(&body);
+    Snapshot header;
+    header.add(SNAPSHOT_MAGIC);
+    header.add(SNAPSHOT_VERSION);
+    header.add((uint64_t)body.getData().size());
+    return header.getData() + body.getData();
+}
+void PySTKRace::loadState(const std::string & state) {
+    auto lock = activate(this);
+    World * world = World::getWorld();
+    if (!world) throw std::invalid_argument("load_state requires a running race");
+    if (state.size() < SNAPSHOT_HEADER_SIZE)
+        throw std::invalid_argument("Snapshot is truncated");
+    Snapshot header(state.substr(0, SNAPSHOT_HEADER_SIZE));
+    if (header.get<uint32_t>() != SNAPSHOT_MAGIC || header.get<uint32_t>() != SNAPSHOT_VERSION)
+        throw std::invalid_argument("Not a snapshot of this version of pystk");
+    if (header.get<uint64_t>() != state.size() - SNAPSHOT_HEADER_SIZE)
+        throw std::invalid_argument("Snapshot is truncated");
+
+    // A snapshot of another race can still fail halfway, the world then
+    // returns to the state it had before
+    const std::string current = saveState();
+    try {
+        Snapshot s(state.substr(SNAPSHOT_HEADER_SIZE));
+        const float time_leftover = s.get<float>();
+        world->restoreState(&s);
+        if (!s.isFullyRead())
+            throw std::runtime_error("Snapshot does not match the current race");
+        time_leftover_ = time_leftover;
+    } catch (std::runtime_error & e) {
+        Snapshot s(current.substr(SNAPSHOT_HEADER_SIZE));
+        s.get<float>();
+        world->restoreState(&s);
+        throw std::invalid_argument(e.what());
+    }
+    last_action_.resize(config_.players.size());
+    for(int i=0; i<last_action_.size(); i++)
+        last_action_[i].get(&world->getPlayerKart(i)->getControls());
+}
 void PySTKRace::start() {
+    auto lock = activate(this);
     race_manager->setupPlayerKartInfo();
     race_manager->startNew();
     time_leftover_ = 0.f;
@@ -358,8 +735,18 @@ void PySTKRace::start() {
     }
     ItemManager::updateRandomSeed(config_.seed);
     powerup_manager->setRandomSeed(config_.seed);
+    for(auto & rt: render_targets_)
+        rt->reset();
+
+    // Mode specific state of battle, soccer and follow the leader worlds is
+    // not part of a snapshot, those modes always reset the world
+    start_state_.clear();
+    if (config_.fast_restart && (config_.mode == PySTKRaceConfig::NORMAL_RACE || config_.mode == PySTKRaceConfig::TIME_TRIAL))
+        start_state_ = saveState();
 }
 void PySTKRace::stop() {
+    // Freeing the render targets frees numpy arrays, which needs the GIL
+    auto lock = activateReleaseGIL(this);
     render_targets_.clear();
     if (CVS->isGLSL())
     {
@@ -383,64 +770,150 @@ void PySTKRace::render(float dt) {
             Camera::getCamera(i)->activate(false);
             render_targets_[i]->render(Camera::getCamera(i)->getCameraSceneNode(), dt);
         }
-        while (render_data_.size() < render_targets_.size()) render_data_.push_back( std::make_shared<PySTKRenderData>() );
-        // Fetch all views
+        // Fetch all views. Every frame gets a fresh PySTKRenderData, such that
+        // render data of earlier frames stays valid until its buffer is reused
+        render_data_.resize(render_targets_.size());
         for(unsigned int i = 0; i < render_targets_.size(); i++) {
+            render_data_[i] = std::make_shared<PySTKRenderData>();
             render_targets_[i]->fetch(render_data_[i]);
         }
+        // Start the transfers now, they overlap with the next simulation step
+        glFlush();
     }
 }
 
 bool PySTKRace::step(const std::vector<PySTKAction> & a) {
-    for(int i=0; i<a.size(); i++) {
-        KartControl & control = World::getWorld()->getPlayerKart(i)->getControls();
-        a[i].set(&control);
+    {
+        auto lock = activate(this);
+        for(int i=0; i<a.size(); i++) {
+            KartControl & control = World::getWorld()->getPlayerKart(i)->getControls();
+            a[i].set(&control);
+        }
     }
+    // step waits for the ring without the lock
     return step();
 }
 bool PySTKRace::step(const PySTKAction & a) {
-    KartControl & control = World::getWorld()->getPlayerKart(0)->getControls();
-    a.set(&control);
+    {
+        auto lock = activate(this);
+        KartControl & control = World::getWorld()->getPlayerKart(0)->getControls();
+        a.set(&control);
+    }
     return step();
 }
-bool PySTKRace::step() {
-    const float dt = config_.step_size;
-    if (!World::getWorld()) return false;
-    
-#ifdef RENDERDOC
-    if(rdoc_api) rdoc_api->StartFrameCapture(NULL, NULL);
-#endif
-
-    // Update first
+bool PySTKRace::update(float dt) {
     time_leftover_ += dt;
     int ticks = stk_config->time2Ticks(time_leftover_);
     time_leftover_ -= stk_config->ticks2Time(ticks);
     for(int i=0; i<ticks; i++) {
         World::getWorld()->updateWorld(1);
         World::getWorld()->updateTime(1);
+        for(const auto & e: Physics::getInstance()->getCollisionEvents()) {
+            PySTKCollision c;
+            c.type = e.m_type;
+            c.kart = e.m_kart;
+            c.other = e.m_other;
+            c.location[0] = e.m_location.getX();
+            c.location[1] = e.m_location.getY();
+            c.location[2] = e.m_location.getZ();
+            c.time = World::getWorld()->getTime();
+            collisions_.push_back(c);
+        }
+        Physics::getInstance()->clearCollisionEvents();
     }
     last_action_.resize(config_.players.size());
     for(int i=0; i<last_action_.size(); i++)
         last_action_[i].get(&World::getWorld()->getPlayerKart(i)->getControls());
     
     PropertyAnimator::get()->update(dt);
-    
-    // Then render
-    if (config_.render) {
+    return race_manager && race_manager->getFinishedPlayers() < race_manager->getNumPlayers();
+}
+bool PySTKRace::updateGraphics(float dt, bool render) {
+    if (config_.render && render) {
         World::getWorld()->updateGraphics(dt);
 
         irr_driver->minimalUpdate(dt);
-        render(dt);
+        this->render(dt);
     } else {
         World::getWorld()->updateGraphicsMinimal(dt);
     }
+    return !config_.render || irr_driver->getDevice()->run();
+}
+bool PySTKRace::step() {
+    waitRing();
+    auto lock = activate(this);
+    const float dt = config_.step_size;
+    if (!World::getWorld()) return false;
+    
+#ifdef RENDERDOC
+    if(rdoc_api) rdoc_api->StartFrameCapture(NULL, NULL);
+#endif
 
-    if (config_.render && !irr_driver->getDevice()->run())
+    // Update first, then render
+    collisions_.clear();
+    bool running = update(dt);
+    if (!updateGraphics(dt, true))
         return false;
 #ifdef RENDERDOC
     if(rdoc_api) rdoc_api->EndFrameCapture(NULL, NULL);
 #endif
-    return race_manager && race_manager->getFinishedPlayers() < race_manager->getNumPlayers();
+    if (ring_)
+        writeRing(!running);
+    return running;
+}
+PySTKStepResult PySTKRace::step(const std::vector<PySTKAction> & a, int repeat, bool render_last_only) {
+    {
+        auto lock = activate(this);
+        for(int i=0; i<a.size(); i++) {
+            KartControl & control = World::getWorld()->getPlayerKart(i)->getControls();
+            a[i].set(&control);
+        }
+    }
+    return step(repeat, render_last_only);
+}
+PySTKStepResult PySTKRace::step(const PySTKAction & a, int repeat, bool render_last_only) {
+    {
+        auto lock = activate(this);
+        KartControl & control = World::getWorld()->getPlayerKart(0)->getControls();
+        a.set(&control);
+    }
+    return step(repeat, render_last_only);
+}
+PySTKStepResult PySTKRace::step(int repeat, bool render_last_only) {
+    waitRing();
+    auto lock = activate(this);
+    const float dt = config_.step_size;
+    PySTKStepResult r;
+    World * world = World::getWorld();
+    if (!world) return r;
+    
+    // The controls stay set for all steps
+    const LinearWorld * lw = dynamic_cast<LinearWorld*>(world);
+    const int n = config_.players.size();
+    r.distance.resize(n);
+    r.collisions.resize(n);
+    for(int i=0; i<n; i++) {
+        const AbstractKart * kart = world->getPlayerKart(i);
+        r.distance[i] = lw ? -lw->getOverallDistance(kart->getWorldKartId()) : 0;
+        r.collisions[i] = -(int)kart->getCollisionCount();
+    }
+    collisions_.clear();
+    for(int it=0; it<std::max(repeat, 1); it++) {
+        bool running = update(dt);
+        // Only render the last step, or the step the race finished
+        bool last = it+1 >= repeat || !running;
+        running = updateGraphics(dt, last || !render_last_only) && running;
+        r.finished.push_back(!running);
+        if (!running) break;
+    }
+    for(int i=0; i<n; i++) {
+        const AbstractKart * kart = world->getPlayerKart(i);
+        r.distance[i] += lw ? lw->getOverallDistance(kart->getWorldKartId()) : 0;
+        r.collisions[i] += kart->getCollisionCount();
+    }
+    if (ring_)
+        writeRing(!r.running());
+    return r;
 }
 
 void PySTKRace::load() {
@@ -511,6 +984,13 @@ void PySTKRace::setupConfig(const PySTKRaceConfig & config) {
     race_manager->setNumLaps(config.laps);
     race_manager->setNumKarts(config.num_kart);
     race_manager->setMaxGoal(1<<30);
+    race_manager->setPhysicsBroadphase(config.physics_broadphase == PySTKRaceConfig::DBVT ? RaceManager::PB_DBVT : RaceManager::PB_AXIS_SWEEP);
+    race_manager->setPhysicsThreads(config.physics_threads);
+    race_manager->setPhysicsFPS(config.physics_fps > 0 ? config.physics_fps : stk_config->getDefaultPhysicsFPS());
+    race_manager->setPhysicsSubsteps(config.physics_substeps);
+    race_manager->setPhysicsSolverIterations(config.physics_solver_iterations);
+    // The race is active already, RaceContext sets the rate when it is activated again
+    stk_config->setPhysicsFPS(race_manager->getPhysicsFPS());
 }
 
 void PySTKRace::initGraphicsConfig(const PySTKGraphicsConfig & config) {
@@ -529,6 +1009,13 @@ void PySTKRace::initGraphicsConfig(const PySTKGraphicsConfig & config) {
     UserConfigParams::m_ssao = config.ssao;
     UserConfigParams::m_degraded_IBL = config.degraded_IBL;
     UserConfigParams::m_high_definition_textures = config.high_definition_textures;
+    UserConfigParams::m_max_texture_size = config.max_texture_size;
+    // Without graphics only the data the simulation needs is loaded
+    CVS->setNoGraphics(!config.render);
+    if (!config.render) {
+        UserConfigParams::m_particles_effects = 0;
+        UserConfigParams::m_animated_characters = false;
+    }
 }
 
 
@@ -548,9 +1035,14 @@ void PySTKRace::initUserConfig()
 }   // initUserConfig
 
 //=============================================================================
-void PySTKRace::initRest()
+/** Creates all managers and reads the description of all tracks and karts.
+ *  Only irrlicht's null device exists at this point, so nothing here may
+ *  create a GL object (or a thread): preload() runs this before worker
+ *  processes are forked. Nothing here may depend on the graphics config
+ *  either, after preload() init() applies it only once this ran.
+ */
+void PySTKRace::initAssets()
 {
-    SP::setMaxTextureSize();
     irr_driver = new IrrDriver();
 
     if (irr_driver->getDevice() == NULL)
@@ -560,13 +1052,6 @@ void PySTKRace::initRest()
 
     StkTime::init();   // grabs the timer object from the irrlicht device
 
-    // Now create the actual non-null device in the irrlicht driver
-    irr_driver->initDevice();
-
-    font_manager = new FontManager();
-    font_manager->loadFonts();
-    SP::loadShaders();
-
     // The order here can be important, e.g. KartPropertiesManager needs
     // defaultKartProperties, which are defined in stk_config.
     material_manager        = new MaterialManager      ();
@@ -576,9 +1061,6 @@ void PySTKRace::initRest()
     powerup_manager         = new PowerupManager       ();
     attachment_manager      = new AttachmentManager    ();
 
-    // The maximum texture size can not be set earlier, since
-    // e.g. the background image needs to be loaded in high res.
-    irr_driver->setMaxTextureSize();
     KartPropertiesManager::addKartSearchDir(
                  file_manager->getAddonsFile("karts/"));
     track_manager->addTrackSearchDir(
@@ -599,9 +1081,34 @@ void PySTKRace::initRest()
     race_manager->setDifficulty(
                  (RaceManager::Difficulty)(int)UserConfigParams::m_difficulty);
 
+    // Only the karts used in a race need their models, they are loaded when
+    // the race creates the karts.
+    kart_properties_manager -> setLoadModelsLazily(true);
     kart_properties_manager -> loadAllKarts(false);
 
-}   // initRest
+}   // initAssets
+
+//=============================================================================
+/** Creates the actual (offscreen) device and its GL context, and loads the
+ *  fonts and shaders.
+ */
+void PySTKRace::initGraphics()
+{
+    SP::setMaxTextureSize();
+
+    // Now create the actual non-null device in the irrlicht driver
+    irr_driver->initDevice();
+
+    font_manager = new FontManager();
+    if (!CVS->isNoGraphics()) {
+        font_manager->loadFonts();
+        SP::loadShaders();
+    }
+
+    // The maximum texture size can not be set earlier, since
+    // e.g. the background image needs to be loaded in high res.
+    irr_driver->setMaxTextureSize();
+}   // initGraphics
 
 //=============================================================================
 /** Frees all manager and their associated memory.
@@ -611,6 +1118,7 @@ void PySTKRace::cleanSuperTuxKart()
     // Stop music (this request will go into the sfx manager queue, so it needs
     // to be done before stopping the thread).
     irr_driver->updateConfigIfRelevant();
+    TrackCache::clear();
     if(race_manager)            delete race_manager;
     race_manager = nullptr;
     if(attachment_manager)      delete attachment_manager;
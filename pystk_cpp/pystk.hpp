@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include "buffer.hpp"
 
@@ -15,10 +17,15 @@ struct PySTKGraphicsConfig {
 	bool ssao = true;
 	bool degraded_IBL = false;
 	int high_definition_textures = 2 | 1;
+	// Load graphics at all, false skips the GL context, shaders and textures
+	bool render = true;
+	// Textures are downscaled to this size, unless high_definition_textures is set
+	int max_texture_size = 512;
 	
 	static const PySTKGraphicsConfig & hd();
 	static const PySTKGraphicsConfig & sd();
 	static const PySTKGraphicsConfig & ld();
+	static const PySTKGraphicsConfig & none();
 };
 struct PySTKPlayerConfig {
 	enum Controller: uint8_t {
@@ -39,6 +46,32 @@ struct PySTKRaceConfig {
 		CAPTURE_THE_FLAG,
 		SOCCER,
 	};
+	enum ColorFormat: uint8_t {
+		COLOR_RGB,
+		COLOR_GRAY,
+		COLOR_NONE,
+	};
+	enum DepthFormat: uint8_t {
+		DEPTH_FLOAT,
+		DEPTH_UINT16,
+		DEPTH_LINEAR_FLOAT,
+		DEPTH_LINEAR_HALF,
+		DEPTH_NONE,
+	};
+	enum InstanceFormat: uint8_t {
+		INSTANCE_ID,
+		INSTANCE_OBJECT_TYPE,
+		INSTANCE_NONE,
+	};
+	enum Filter: uint8_t {
+		NEAREST,
+		AREA,
+		MODE,
+	};
+	enum Broadphase: uint8_t {
+		AXIS_SWEEP,
+		DBVT,
+	};
 	
 	int difficulty = 2;
 	RaceMode mode = NORMAL_RACE;
@@ -50,16 +83,35 @@ struct PySTKRaceConfig {
 	int num_kart = 1;
 	float step_size = 0.1;
 	bool render = true;
+	int readback_buffers = 2;
+	bool zero_copy = false;
+	ColorFormat color_format = COLOR_RGB;
+	DepthFormat depth_format = DEPTH_FLOAT;
+	InstanceFormat instance_format = INSTANCE_ID;
+	int observation_width = 0;
+	int observation_height = 0;
+	int frame_stack = 1;
+	Filter color_filter = AREA;
+	Filter instance_filter = NEAREST;
+	bool fast_restart = false;
+	Broadphase physics_broadphase = AXIS_SWEEP;
+	int physics_threads = 1;
+	int physics_fps = 0;
+	int physics_substeps = 1;
+	int physics_solver_iterations = 0;
 };
 
 class PySTKRenderTarget;
 
 struct PySTKRenderData {
     std::shared_ptr<NumpyPBO> color_buf_, depth_buf_, instance_buf_;
+    bool ready() const;
 };
 
 class KartControl;
 class Controller;
+class RaceContext;
+class PySTKRing;
 struct PySTKAction {
 	float steering_angle = 0;
 	float acceleration = 0;
@@ -72,32 +124,83 @@ struct PySTKAction {
 	void get(const KartControl * control);
 };
 
+struct PySTKStepResult {
+	// Has the race finished after each step taken (at most repeat steps)
+	std::vector<bool> finished;
+	// Overall distance driven during the steps (per player)
+	std::vector<float> distance;
+	// Number of collisions during the steps (per player)
+	std::vector<int> collisions;
+	bool running() const { return finished.size() && !finished.back(); }
+};
+
+struct PySTKCollision {
+	enum Type: uint8_t {
+		KART_KART, KART_TRACK, KART_OBJECT, FLYABLE_KART, FLYABLE_TRACK, FLYABLE_OBJECT, FLYABLE_FLYABLE
+	};
+	uint8_t type;
+	// World kart id of the kart (or of the owner of the flyable)
+	int32_t kart;
+	// World kart id of the other kart (or of the owner of the other flyable), -1 otherwise
+	int32_t other;
+	float location[3];
+	// Race time of the collision
+	float time;
+};
+
 class PySTKRace {
 protected: // Static methods
-	static void initRest();
+	static void initAssets();
+	// Reads the user and stk config, applies config (or the settings without graphics) and calls initAssets
+	static void loadAssets(const PySTKGraphicsConfig * config);
+	static void initGraphics();
 	static void initUserConfig();
 	static void initGraphicsConfig(const PySTKGraphicsConfig & config);
 	static void cleanSuperTuxKart();
 	static void cleanUserConfig();
 
 public: // Static methods
-	static PySTKRace * running_kart;
+	static std::vector<PySTKRace *> running_races;
 	static void init(const PySTKGraphicsConfig & config);
+	// Loads everything that does not need a GL context, call before forking workers that each call init
+	static void preload();
 	static void load();
 	static void clean();
 	static bool isRunning();
 	static std::vector<std::string> listTracks();
 	static std::vector<std::string> listKarts();
+	static void setTrackCacheSize(float size_mb);
+	static float trackCacheSize();
+	// Loads the textures of all karts and tracks, which fills the texture cache
+	static void warmTextureCache();
+	// Locks all races and makes race the active one (if not null) while the lock is held
+	static std::unique_lock<std::recursive_mutex> activate(const PySTKRace * race);
+	// Same as activate, but waits for the lock without the GIL (another thread may hold the lock and step), the GIL is held again on return
+	static std::unique_lock<std::recursive_mutex> activateReleaseGIL(const PySTKRace * race);
 
 protected:
 	void setupConfig(const PySTKRaceConfig & config);
 	void setupRaceStart();
 	void render(float dt);
+	bool update(float dt);
+	bool updateGraphics(float dt, bool render);
 	std::vector<std::unique_ptr<PySTKRenderTarget> > render_targets_;
 	std::vector<std::shared_ptr<PySTKRenderData> > render_data_;
 	PySTKRaceConfig config_;
 	float time_leftover_ = 0;
 	std::vector<PySTKAction> last_action_;
+	// Snapshot of the race right after start, used by restart if fast_restart is set
+	std::string start_state_;
+	// Every step writes its render data and the player state into the ring (if any)
+	std::shared_ptr<PySTKRing> ring_;
+	std::atomic<float> ring_timeout_{-1};
+	// Waits for a free slot in the ring, before the step takes the lock
+	void waitRing() const;
+	void writeRing(bool finished);
+	// World, physics, items and track of this race
+	std::unique_ptr<RaceContext> context_;
+	// Collisions during the last step (all repeated steps)
+	std::vector<PySTKCollision> collisions_;
 
 public:
 	PySTKRace(const PySTKRace &) = delete;
@@ -106,11 +209,20 @@ public:
 	~PySTKRace();
 	void restart();
 	void start();
+	std::string saveState() const;
+	void loadState(const std::string & state);
 	bool step(const std::vector<PySTKAction> &);
 	bool step(const PySTKAction &);
 	bool step();
+	PySTKStepResult step(const std::vector<PySTKAction> &, int repeat, bool render_last_only=true);
+	PySTKStepResult step(const PySTKAction &, int repeat, bool render_last_only=true);
+	PySTKStepResult step(int repeat, bool render_last_only=true);
 	void stop();
+	// Creates a shared memory ring that every step writes its observation to
+	void attachRing(const std::string & name, int num_slots, float timeout);
+	void detachRing();
 	const std::vector<std::shared_ptr<PySTKRenderData> > & render_data() const { return render_data_; }
 	const std::vector<PySTKAction> & last_action() const { return last_action_; }
+	const std::vector<PySTKCollision> & collisions() const { return collisions_; }
 	const PySTKRaceConfig & config() const { return config_; }
 };
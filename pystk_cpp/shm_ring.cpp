@@ -0,0 +1,193 @@
+#include "shm_ring.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const uint64_t RING_MAGIC = 0x474e524b54535950ull; // "PYSTKRNG"
+static const uint32_t RING_VERSION = 1;
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "PySTKRing needs lock-free 64 bit atomics in shared memory");
+
+// Layout of the start of the shared memory, followed by the slots
+struct PySTKRingHeader {
+	// Written last by the producer, see RING_MAGIC
+	std::atomic<uint64_t> magic;
+	uint32_t version, num_slots, num_fields;
+	uint64_t slot_size, slot_offset;
+	PySTKRingField fields[PySTKRing::MAX_FIELDS];
+	// Number of slots written (producer) and read (consumer), on separate cache lines
+	alignas(64) std::atomic<uint64_t> head;
+	alignas(64) std::atomic<uint64_t> tail;
+	alignas(64) std::atomic<uint64_t> dropped;
+	std::atomic<uint32_t> closed;
+};
+
+static size_t align(size_t s, size_t a) { return (s + a - 1) / a * a; }
+
+// Waits until ready() or the timeout (in seconds, forever if negative) expired
+template<typename F> static bool wait_for(F ready, float timeout) {
+	auto end = std::chrono::steady_clock::now() + std::chrono::duration<float>(timeout);
+	for(int i=0; !ready(); i++) {
+		if (timeout >= 0 && std::chrono::steady_clock::now() >= end)
+			return false;
+		// Spin briefly, then sleep to leave the core to the other side
+		if (i < 64)
+			std::this_thread::yield();
+		else
+			std::this_thread::sleep_for(std::chrono::microseconds(50));
+	}
+	return true;
+}
+
+#ifdef WIN32
+PySTKRing::PySTKRing(const std::string & name, std::vector<PySTKRingField> fields, int num_slots) {
+	throw std::invalid_argument("Shared memory rings are not supported on Windows!");
+}
+PySTKRing::PySTKRing(const std::string & name) {
+	throw std::invalid_argument("Shared memory rings are not supported on Windows!");
+}
+PySTKRing::~PySTKRing() {}
+#else
+PySTKRing::PySTKRing(const std::string & name, std::vector<PySTKRingField> fields, int num_slots): name_(name), owner_(true) {
+	if (num_slots < 1)
+		throw std::invalid_argument("A ring needs at least one slot!");
+	if (fields.size() > MAX_FIELDS)
+		throw std::invalid_argument("Too many fields in a ring!");
+	uint64_t slot_size = 0;
+	for(auto & f: fields) {
+		f.offset = slot_size;
+		slot_size = align(slot_size + f.size, 64);
+	}
+	const size_t slot_offset = align(sizeof(PySTKRingHeader), 4096);
+	size_ = slot_offset + slot_size * num_slots;
+
+	int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (fd < 0)
+		throw std::invalid_argument("Cannot create the shared memory '"+name+"': "+strerror(errno));
+	if (ftruncate(fd, size_) != 0) {
+		::close(fd);
+		shm_unlink(name.c_str());
+		throw std::invalid_argument("Cannot allocate the shared memory '"+name+"'");
+	}
+	data_ = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (data_ == MAP_FAILED) {
+		data_ = nullptr;
+		shm_unlink(name.c_str());
+		throw std::invalid_argument("Cannot map the shared memory '"+name+"'");
+	}
+
+	PySTKRingHeader * h = new (data_) PySTKRingHeader();
+	h->version = RING_VERSION;
+	h->num_slots = num_slots;
+	h->num_fields = fields.size();
+	h->slot_size = slot_size;
+	h->slot_offset = slot_offset;
+	std::copy(fields.begin(), fields.end(), h->fields);
+	h->head.store(0);
+	h->tail.store(0);
+	h->dropped.store(0);
+	h->closed.store(0);
+	// The magic is written last, a consumer never opens a half initialized ring
+	h->magic.store(RING_MAGIC, std::memory_order_release);
+}
+PySTKRing::PySTKRing(const std::string & name): name_(name), owner_(false) {
+	int fd = shm_open(name.c_str(), O_RDWR, 0600);
+	if (fd < 0)
+		throw std::invalid_argument("Cannot open the shared memory '"+name+"': "+strerror(errno));
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(PySTKRingHeader)) {
+		::close(fd);
+		throw std::invalid_argument("'"+name+"' is not an observation ring");
+	}
+	size_ = st.st_size;
+	data_ = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (data_ == MAP_FAILED) {
+		data_ = nullptr;
+		throw std::invalid_argument("Cannot map the shared memory '"+name+"'");
+	}
+	const PySTKRingHeader * h = header();
+	if (h->magic.load(std::memory_order_acquire) != RING_MAGIC || h->version != RING_VERSION ||
+	    h->slot_offset + h->slot_size * h->num_slots > size_) {
+		munmap(data_, size_);
+		data_ = nullptr;
+		throw std::invalid_argument("'"+name+"' is not an observation ring");
+	}
+}
+PySTKRing::~PySTKRing() {
+	if (!data_) return;
+	if (owner_) {
+		header()->closed.store(1, std::memory_order_release);
+		// The consumer keeps its mapping, only the name is removed
+		shm_unlink(name_.c_str());
+	}
+	munmap(data_, size_);
+}
+#endif
+
+PySTKRingHeader * PySTKRing::header() const {
+	return static_cast<PySTKRingHeader*>(data_);
+}
+char * PySTKRing::slot(uint64_t i) const {
+	const PySTKRingHeader * h = header();
+	return static_cast<char*>(data_) + h->slot_offset + (i % h->num_slots) * h->slot_size;
+}
+bool PySTKRing::wait(float timeout) const {
+	const PySTKRingHeader * h = header();
+	const uint64_t head = h->head.load(std::memory_order_relaxed);
+	return wait_for([h, head]() { return head - h->tail.load(std::memory_order_acquire) < h->num_slots; }, timeout);
+}
+char * PySTKRing::acquire(float timeout) {
+	if (!wait(timeout))
+		return nullptr;
+	return slot(header()->head.load(std::memory_order_relaxed));
+}
+void PySTKRing::commit() {
+	PySTKRingHeader * h = header();
+	h->head.store(h->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+void PySTKRing::drop() {
+	header()->dropped.fetch_add(1, std::memory_order_relaxed);
+}
+const char * PySTKRing::peek(float timeout) const {
+	const PySTKRingHeader * h = header();
+	const uint64_t tail = h->tail.load(std::memory_order_relaxed);
+	auto ready = [h, tail]() { return h->head.load(std::memory_order_acquire) > tail || h->closed.load(std::memory_order_acquire); };
+	if (!wait_for(ready, timeout) || h->head.load(std::memory_order_acquire) <= tail)
+		return nullptr;
+	return slot(tail);
+}
+void PySTKRing::release() {
+	PySTKRingHeader * h = header();
+	const uint64_t tail = h->tail.load(std::memory_order_relaxed);
+	if (h->head.load(std::memory_order_acquire) > tail)
+		h->tail.store(tail + 1, std::memory_order_release);
+}
+std::vector<PySTKRingField> PySTKRing::fields() const {
+	const PySTKRingHeader * h = header();
+	return std::vector<PySTKRingField>(h->fields, h->fields + h->num_fields);
+}
+int PySTKRing::numSlots() const {
+	return header()->num_slots;
+}
+int PySTKRing::pending() const {
+	const PySTKRingHeader * h = header();
+	return h->head.load(std::memory_order_acquire) - h->tail.load(std::memory_order_acquire);
+}
+uint64_t PySTKRing::dropped() const {
+	return header()->dropped.load(std::memory_order_relaxed);
+}
+bool PySTKRing::closed() const {
+	return header()->closed.load(std::memory_order_acquire);
+}
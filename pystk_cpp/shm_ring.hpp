@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Describes one array in each slot of a PySTKRing
+struct PySTKRingField {
+	char name[24];
+	// numpy type string, e.g. "u1" or "f4"
+	char dtype[4];
+	int32_t ndim;
+	int32_t shape[4];
+	// Position and size in bytes of the array in a slot
+	uint64_t offset, size;
+};
+
+// A ring of observation slots in POSIX shared memory, written by one process
+// and read by another (single producer, single consumer). The producer waits
+// while all slots hold unread observations, which throttles it to the speed
+// of the consumer.
+class PySTKRing {
+protected:
+	std::string name_;
+	void * data_ = nullptr;
+	size_t size_ = 0;
+	bool owner_ = false;
+	struct PySTKRingHeader * header() const;
+	char * slot(uint64_t i) const;
+	PySTKRing(const PySTKRing &) = delete;
+	PySTKRing& operator=(const PySTKRing &) = delete;
+
+public:
+	static const int MAX_FIELDS = 32;
+	// Creates the ring (producer), offset and size of the fields are computed here
+	PySTKRing(const std::string & name, std::vector<PySTKRingField> fields, int num_slots);
+	// Opens an existing ring (consumer)
+	explicit PySTKRing(const std::string & name);
+	// The producer marks the ring closed and removes its name
+	~PySTKRing();
+
+	// Producer: waits up to timeout seconds (forever if negative) while the
+	// ring is full, true if a slot is free. A free slot stays free until the
+	// producer commits it.
+	bool wait(float timeout) const;
+	// Producer: returns the next free slot, waiting up to timeout seconds
+	// (forever if negative) while the ring is full. nullptr on timeout.
+	char * acquire(float timeout);
+	// Producer: publishes the slot returned by acquire
+	void commit();
+	// Producer: counts an observation that was dropped since the ring was full
+	void drop();
+
+	// Consumer: returns the oldest unread slot, waiting up to timeout seconds
+	// (forever if negative). nullptr on timeout, or if the ring is closed and empty.
+	const char * peek(float timeout) const;
+	// Consumer: frees the slot returned by peek, the producer reuses it
+	void release();
+
+	const std::string & name() const { return name_; }
+	std::vector<PySTKRingField> fields() const;
+	int numSlots() const;
+	// Number of unread slots
+	int pending() const;
+	// Number of observations dropped by the producer
+	uint64_t dropped() const;
+	bool closed() const;
+};
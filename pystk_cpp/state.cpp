@@ -27,6 +27,7 @@
 #include "utils/vec3.hpp"
 #include "view.hpp"
 #include "pickle.hpp"
+#include "pystk.hpp"
 #include <physics/btKart.hpp>
 
 namespace py = pybind11;
@@ -56,6 +57,9 @@ void unpickle(std::istream & s, PyTrack * o);
 struct PyWorldState;
 void pickle(std::ostream & s, const PyWorldState & o);
 void unpickle(std::istream & s, PyWorldState * o);
+struct PyWorldStateArrays;
+void pickle(std::ostream & s, const PyWorldStateArrays & o);
+void unpickle(std::istream & s, PyWorldStateArrays * o);
 // End AUTO Generated
 
 typedef std::array<float, 3> PyVec3;
@@ -515,12 +519,13 @@ struct PyTrack {
 		  R(path_width, "Width of the path segment (float N)")
 		  R(path_distance, "Distance down the track of each line segment (float N x 2)")
 #undef R
-		 .def("update", &PyTrack::update) 
+		 .def("update", &PyTrack::update, py::arg("race")=nullptr, "Update the track of race (or of the race that was used last)") 
 		 .def("__repr__", [](const PyTrack &t) { return "<Track length="+std::to_string(t.length)+">"; });
 		add_pickle(c);
 	}
 	
-	void update() {
+	void update(const PySTKRace * race) {
+		auto lock = PySTKRace::activateReleaseGIL(race);
 		const Track * t = Track::getCurrentTrack();
 		if (t) {
 			length = t->getTrackLength();
@@ -561,10 +566,10 @@ struct PyWorldState {
 		  R(soccer, "Soccer match info")
 		  R(ffa, "Free for all match info")
 #undef R
-		 .def("update", &PyWorldState::update, "Update this object with the current world state")
+		 .def("update", &PyWorldState::update, py::arg("race")=nullptr, py::call_guard<py::gil_scoped_release>(), "Update this object with the current world state of race (or of the race that was used last)")
 		 .def("__repr__", [](const PyWorldState &k) { return "<WorldState #karts="+std::to_string(k.karts.size())+">"; })
-		 .def_static("set_ball_location", &PyWorldState::set_ball_location, py::arg("position"), py::arg("velocity")=PyVec3{0,0,0}, py::arg("angular_velocity")=PyVec3{0,0,0}, "Specify the soccer ball / hockey puck position (SOCCER mode only).")
-		 .def_static("set_kart_location", &PyWorldState::set_kart_location, py::arg("kart_id"), py::arg("position"), py::arg("rotation")=PyQuaternion{0,0,0,1}, py::arg("speed")=0, "Move a kart to a specific location.");
+		 .def_static("set_ball_location", &PyWorldState::set_ball_location, py::arg("position"), py::arg("velocity")=PyVec3{0,0,0}, py::arg("angular_velocity")=PyVec3{0,0,0}, py::call_guard<py::gil_scoped_release>(), "Specify the soccer ball / hockey puck position (SOCCER mode only).")
+		 .def_static("set_kart_location", &PyWorldState::set_kart_location, py::arg("kart_id"), py::arg("position"), py::arg("rotation")=PyQuaternion{0,0,0,1}, py::arg("speed")=0, py::call_guard<py::gil_scoped_release>(), "Move a kart to a specific location.");
 		// TODO: Add pickling and make sure players are updated
 		add_pickle(c);
 	}
@@ -573,7 +578,8 @@ struct PyWorldState {
 			if (k->player_id >= 0)
 				players[k->player_id]->kart = k;
 	}
-	void update() {
+	void update(const PySTKRace * race) {
+		auto lock = PySTKRace::activate(race);
 		World * w = World::getWorld();
 		LinearWorld * lw = dynamic_cast<LinearWorld*>(w);
 		SoccerWorld * sw = dynamic_cast<SoccerWorld*>(w);
@@ -633,6 +639,7 @@ struct PyWorldState {
 		}
 	}
 	static void set_ball_location(const PyVec3 & position, const PyVec3 & velocity, const PyVec3 & angular_velocity) {
+		auto lock = PySTKRace::activate(nullptr);
 		World * w = World::getWorld();
 		SoccerWorld * sw = dynamic_cast<SoccerWorld*>(World::getWorld());
 		if (sw) {
@@ -640,6 +647,7 @@ struct PyWorldState {
 		}
 	}
 	static void set_kart_location(int id, const PyVec3 & position, const PyQuaternion & rotation, float speed) {
+		auto lock = PySTKRace::activate(nullptr);
 		World * w = World::getWorld();
 		World::KartList k = w->getKarts();
 		if (0 <= id && id < k.size()) {
@@ -656,6 +664,141 @@ struct PyWorldState {
 	}
 };
 
+// Reallocate a only if its shape changes, otherwise it is filled in place
+template<typename T>
+static void resize(py::array_t<T> & a, std::vector<ssize_t> shape) {
+	if (!a || a.ndim() != shape.size() || !std::equal(shape.begin(), shape.end(), a.shape()))
+		a = py::array_t<T>(shape);
+}
+
+struct PyWorldStateArrays {
+	float time = 0;
+	py::array_t<int> kart_id, kart_player_id;
+	py::array_t<float> kart_location, kart_rotation, kart_front, kart_velocity;
+	py::array_t<int> kart_finished_laps;
+	py::array_t<float> kart_overall_distance, kart_distance_down_track;
+	py::array_t<uint8_t> kart_attachment, kart_powerup;
+	py::array_t<float> kart_attachment_time_left;
+	py::array_t<int> kart_powerup_num;
+	py::array_t<int> item_id;
+	py::array_t<float> item_location, item_size;
+	py::array_t<uint8_t> item_type;
+	
+	static void define(py::object m) {
+		py::class_<PyWorldStateArrays, std::shared_ptr<PyWorldStateArrays>> c(m, "WorldStateArrays", "Struct of arrays version of WorldState. All arrays are filled in place by update, as long as the number of karts and items stays the same.");
+		c.def(py::init<>())
+#define R(x, d) .def_readonly(#x, &PyWorldStateArrays::x, d)
+		  R(time, "Game time")
+		  R(kart_id, "Kart id compatible with instance labels (int N)")
+		  R(kart_player_id, "Player id, -1 for AI karts (int N)")
+		  R(kart_location, "3D world location of the karts (float N x 3)")
+		  R(kart_rotation, "Quaternion rotation of the karts (float N x 4)")
+		  R(kart_front, "Front direction of the karts 1/2 kart length forward from location (float N x 3)")
+		  R(kart_velocity, "Velocity of the karts (float N x 3)")
+		  R(kart_finished_laps, "Number of laps completed (int N)")
+		  R(kart_overall_distance, "Overall distance traveled (float N)")
+		  R(kart_distance_down_track, "Distance traveled on current lap (float N)")
+		  R(kart_attachment, "Attachment.Type of the karts (uint8 N)")
+		  R(kart_attachment_time_left, "Seconds until the attachment detaches/explodes (float N)")
+		  R(kart_powerup, "Powerup.Type of the karts (uint8 N)")
+		  R(kart_powerup_num, "Number of powerups (int N)")
+		  R(item_id, "Item id compatible with instance data (int M)")
+		  R(item_location, "3D world location of the items (float M x 3)")
+		  R(item_size, "Size of the items (float M)")
+		  R(item_type, "Item.Type of the items (uint8 M)")
+#undef R
+		 .def("update", &PyWorldStateArrays::update, py::arg("race")=nullptr, "Update all arrays with the current world state of race (or of the race that was used last)")
+		 .def("__repr__", [](const PyWorldStateArrays &k) { return "<WorldStateArrays #karts="+std::to_string(k.kart_id.size())+" #items="+std::to_string(k.item_id.size())+">"; });
+		add_pickle(c);
+	}
+	void update(const PySTKRace * race) {
+		auto lock = PySTKRace::activateReleaseGIL(race);
+		World * w = World::getWorld();
+		LinearWorld * lw = dynamic_cast<LinearWorld*>(w);
+		if (w) {
+			const World::KartList & k = w->getKarts();
+			const ssize_t N = k.size();
+			resize(kart_id, {N});
+			resize(kart_player_id, {N});
+			resize(kart_location, {N, 3});
+			resize(kart_rotation, {N, 4});
+			resize(kart_front, {N, 3});
+			resize(kart_velocity, {N, 3});
+			resize(kart_finished_laps, {N});
+			resize(kart_overall_distance, {N});
+			resize(kart_distance_down_track, {N});
+			resize(kart_attachment, {N});
+			resize(kart_attachment_time_left, {N});
+			resize(kart_powerup, {N});
+			resize(kart_powerup_num, {N});
+			auto id = kart_id.mutable_unchecked<1>();
+			auto player_id = kart_player_id.mutable_unchecked<1>();
+			auto location = kart_location.mutable_unchecked<2>();
+			auto rotation = kart_rotation.mutable_unchecked<2>();
+			auto front = kart_front.mutable_unchecked<2>();
+			auto velocity = kart_velocity.mutable_unchecked<2>();
+			auto laps = kart_finished_laps.mutable_unchecked<1>();
+			auto overall_distance = kart_overall_distance.mutable_unchecked<1>();
+			auto distance_down_track = kart_distance_down_track.mutable_unchecked<1>();
+			auto attachment = kart_attachment.mutable_unchecked<1>();
+			auto attachment_time_left = kart_attachment_time_left.mutable_unchecked<1>();
+			auto powerup = kart_powerup.mutable_unchecked<1>();
+			auto powerup_num = kart_powerup_num.mutable_unchecked<1>();
+			int pid = 0;
+			for(ssize_t i=0; i<N; i++) {
+				const AbstractKart * kart = k[i].get();
+				id(i) = kart->getWorldKartId();
+				player_id(i) = kart->getController()->isLocalPlayerController() ? pid++ : -1;
+				const Vec3 & xyz = kart->getXYZ(), & f = kart->getFrontXYZ();
+				const Vec3 v = kart->getVelocity();
+				const btQuaternion & q = kart->getRotation();
+				for(int j=0; j<3; j++) {
+					location(i, j) = xyz[j];
+					front(i, j) = f[j];
+					velocity(i, j) = v[j];
+				}
+				rotation(i, 0) = q.x(); rotation(i, 1) = q.y(); rotation(i, 2) = q.z(); rotation(i, 3) = q.w();
+				laps(i) = lw ? lw->getFinishedLapsOfKart(i) : 0;
+				overall_distance(i) = lw ? lw->getOverallDistance(i) : 0;
+				distance_down_track(i) = lw ? lw->getDistanceDownTrackForKart(i, true) : 0;
+				const Attachment * a = kart->getAttachment();
+				attachment(i) = a ? a->getType() : Attachment::ATTACH_NOTHING;
+				attachment_time_left(i) = a ? stk_config->ticks2Time(a->getTicksLeft()) : 0;
+				const Powerup * p = kart->getPowerup();
+				powerup(i) = p ? p->getType() : PowerupManager::POWERUP_NOTHING;
+				powerup_num(i) = p ? p->getNum() : 0;
+			}
+			time = w->getTime();
+		}
+		ItemManager * im = ItemManager::get();
+		if (im) {
+			ssize_t M = 0;
+			for(int i=0; i<im->getNumberOfItems(); i++)
+				M += PyItem::isValid(dynamic_cast<const Item*>(im->getItem(i)));
+			resize(item_id, {M});
+			resize(item_location, {M, 3});
+			resize(item_size, {M});
+			resize(item_type, {M});
+			auto id = item_id.mutable_unchecked<1>();
+			auto location = item_location.mutable_unchecked<2>();
+			auto size = item_size.mutable_unchecked<1>();
+			auto type = item_type.mutable_unchecked<1>();
+			for(int i=0, n=0; i<im->getNumberOfItems() && n<M; i++) {
+				const Item * I = dynamic_cast<const Item*>(im->getItem(i));
+				if (PyItem::isValid(I)) {
+					const Vec3 & xyz = I->getXYZ();
+					id(n) = I->getObjectId();
+					for(int j=0; j<3; j++)
+						location(n, j) = xyz[j];
+					size(n) = I->getAvoidancePoint(0) ? (xyz - *I->getAvoidancePoint(0)).length() : 1.1;
+					type(n) = I->getType();
+					n++;
+				}
+			}
+		}
+	}
+};
+
 // AUTO Generated //
 void pickle(std::ostream & s, const PyAttachment & o) {
     pickle(s, o.type);
@@ -806,6 +949,46 @@ void unpickle(std::istream & s, PyWorldState * o) {
 	unpickle(s, &o->soccer);
 	o->assignPlayersKart();
 }
+void pickle(std::ostream & s, const PyWorldStateArrays & o) {
+    pickle(s, o.time);
+    ::pickle(s, o.kart_id);
+    ::pickle(s, o.kart_player_id);
+    ::pickle(s, o.kart_location);
+    ::pickle(s, o.kart_rotation);
+    ::pickle(s, o.kart_front);
+    ::pickle(s, o.kart_velocity);
+    ::pickle(s, o.kart_finished_laps);
+    ::pickle(s, o.kart_overall_distance);
+    ::pickle(s, o.kart_distance_down_track);
+    ::pickle(s, o.kart_attachment);
+    ::pickle(s, o.kart_attachment_time_left);
+    ::pickle(s, o.kart_powerup);
+    ::pickle(s, o.kart_powerup_num);
+    ::pickle(s, o.item_id);
+    ::pickle(s, o.item_location);
+    ::pickle(s, o.item_size);
+    ::pickle(s, o.item_type);
+}
+void unpickle(std::istream & s, PyWorldStateArrays * o) {
+    unpickle(s, &o->time);
+    ::unpickle(s, &o->kart_id);
+    ::unpickle(s, &o->kart_player_id);
+    ::unpickle(s, &o->kart_location);
+    ::unpickle(s, &o->kart_rotation);
+    ::unpickle(s, &o->kart_front);
+    ::unpickle(s, &o->kart_velocity);
+    ::unpickle(s, &o->kart_finished_laps);
+    ::unpickle(s, &o->kart_overall_distance);
+    ::unpickle(s, &o->kart_distance_down_track);
+    ::unpickle(s, &o->kart_attachment);
+    ::unpickle(s, &o->kart_attachment_time_left);
+    ::unpickle(s, &o->kart_powerup);
+    ::unpickle(s, &o->kart_powerup_num);
+    ::unpickle(s, &o->item_id);
+    ::unpickle(s, &o->item_location);
+    ::unpickle(s, &o->item_size);
+    ::unpickle(s, &o->item_type);
+}
 // End AUTO Generated //
 
 
@@ -821,6 +1004,13 @@ void defineState(py::object m) {
 	PySoccer::define(m);
 	PyFFA::define(m);
 	PyWorldState::define(m);
+	PyWorldStateArrays::define(m);
 	PyTrack::define(m);
 };
 
+void updateWorldState(std::shared_ptr<PyWorldState> & state, const PySTKRace * race) {
+	if (!state)
+		state = std::make_shared<PyWorldState>();
+	state->update(race);
+}
+
@@ -1,6 +1,11 @@
 #pragma once
+#include <memory>
 
 namespace pybind11 {
 	class object;
 }
 void defineState(pybind11::object m);
+struct PyWorldState;
+class PySTKRace;
+// Create (if needed) and update a WorldState without a python call, used by the benchmark
+void updateWorldState(std::shared_ptr<PyWorldState> & state, const PySTKRace * race);
@@ -120,7 +120,7 @@ void STKConfig::load(const std::string &filename)
         Log::fatal("StkConfig", "Invalid default port values.");
     }
     CHECK_NEG(m_max_karts,                 "<karts max=..."             );
-    CHECK_NEG(m_item_switch_ticks,         "item switch-time"           );
+    CHECK_NEG(m_item_switch_time,          "item switch-time"           );
     CHECK_NEG(m_bubblegum_counter,         "bubblegum disappear counter");
     CHECK_NEG(m_explosion_impulse_objects, "explosion-impulse-objects"  );
     CHECK_NEG(m_max_skidmarks,             "max-skidmarks"              );
@@ -134,7 +134,7 @@ void STKConfig::load(const std::string &filename)
     CHECK_NEG(m_near_ground,               "near-ground"                );
     CHECK_NEG(m_delay_finish_time,         "delay-finish-time"          );
     CHECK_NEG(m_leader_time_per_kart,      "leader time-per-kart"       );
-    CHECK_NEG(m_penalty_ticks,             "penalty-time"               );
+    CHECK_NEG(m_penalty_time,              "penalty-time"               );
     CHECK_NEG(m_max_display_news,          "max-display-news"           );
     CHECK_NEG(m_replay_max_frames,         "replay max-frames"          );
     CHECK_NEG(m_replay_delta_steering,     "replay delta-steering"      );
@@ -167,9 +167,10 @@ void STKConfig::init_defaults()
         m_near_ground            = m_solver_split_impulse_thresh =
         m_smooth_angle_limit     = m_default_track_friction      =
         m_default_moveable_friction =    UNDEFINED;
-    m_item_switch_ticks          = -100;
-    m_penalty_ticks              = -100;
+    m_item_switch_time           = -100;
+    m_penalty_time               = -100;
     m_physics_fps                = -100;
+    m_default_physics_fps        = -100;
     m_bubblegum_counter          = -100;
     m_shield_restrict_weapons    = false;
     m_max_karts                  = -100;
@@ -277,6 +278,7 @@ void STKConfig::getAllData(const XMLNode * root)
         physics_node->get("default-moveable-friction",
                                                  &m_default_moveable_friction);
         physics_node->get("fps",                    &m_physics_fps           );
+        m_default_physics_fps = m_physics_fps;
         physics_node->get("solver-iterations",      &m_solver_iterations     );
         physics_node->get("solver-split-impulse",   &m_solver_split_impulse  );
         physics_node->get("solver-split-impulse-threshold",
@@ -317,9 +319,7 @@ void STKConfig::getAllData(const XMLNode * root)
 
     if (const XMLNode *startup_node= root->getNode("startup"))
     {
-        float f;
-        startup_node->get("penalty", &f);
-        m_penalty_ticks = time2Ticks(f);
+        startup_node->get("penalty", &m_penalty_time);
     }
 
     if (const XMLNode *news_node= root->getNode("news"))
@@ -378,9 +378,7 @@ void STKConfig::getAllData(const XMLNode * root)
     if(const XMLNode *switch_node= root->getNode("switch"))
     {
         switch_node->get("items", &m_switch_items    );
-        float f;
-        if( switch_node->get("time",  &f) )
-            m_item_switch_ticks = stk_config->time2Ticks(f);
+        switch_node->get("time",  &m_item_switch_time);
     }
 
     if(const XMLNode *bubblegum_node= root->getNode("bubblegum"))
@@ -70,13 +70,13 @@ public:
     float m_bomb_time;                 /**<Time before a bomb explodes.        */
     float m_bomb_time_increase;        /**<Time added to bomb timer when it's
                                            passed on.                          */
-    int   m_item_switch_ticks;          /**< Time items will be switched.       */
+    float m_item_switch_time;          /**< Time items will be switched.       */
     int   m_bubblegum_counter;         /**< How many times bubble gums must be
                                             driven over before they disappear. */
     bool  m_shield_restrict_weapons;   /**<Wether weapon usage is punished. */
     float m_explosion_impulse_objects; /**<Impulse of explosion on moving
                                             objects, e.g. road cones, ...      */
-    int   m_penalty_ticks;              /**< Penalty time when starting too
+    float m_penalty_time;              /**< Penalty time when starting too
                                             early.                             */
     float m_delay_finish_time;         /**<Delay after a race finished before
                                            the results are displayed.          */
@@ -201,9 +201,12 @@ private:
      *  loaded a user specified config file. */
     bool  m_has_been_loaded;
 
-    /** Default FPS rate for physics. */
+    /** FPS rate for physics (and all game logic) of the active race. */
     int m_physics_fps;
 
+    /** FPS rate for physics from the config file. */
+    int m_default_physics_fps;
+
     std::string m_title_music_file;
     std::string m_default_music_file;
 public:
@@ -237,8 +240,13 @@ public:
     // ------------------------------------------------------------------------
     /** Returns the physics frame per seconds rate. */
     int getPhysicsFPS() const { return m_physics_fps; }
-    
+    // ------------------------------------------------------------------------
+    /** Sets the physics rate of the active race. All times that are stored
+     *  in ticks have to be converted with the rate of their race. */
     void setPhysicsFPS(int fps) { m_physics_fps = fps; }
+    // ------------------------------------------------------------------------
+    /** Returns the physics rate of the config file. */
+    int getDefaultPhysicsFPS() const { return m_default_physics_fps; }
 }
 ;   // STKConfig
 
@@ -111,6 +111,8 @@ private:
     /** List of all cameras. */
     static std::vector<Camera*> m_all_cameras;
 
+    friend class RaceContext;
+
     void setupCamera();
 
 protected:
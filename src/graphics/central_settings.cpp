@@ -56,9 +56,15 @@ void CentralVideoSettings::init()
     hasBGRA = false;
     hasColorBufferFloat = false;
     hasTextureBufferObject = false;
+    hasProgramBinary = false;
     m_need_vertex_id_workaround = false;
 
     // Call to glGetIntegerv should not be made if --no-graphics is used
+    if (m_no_graphics)
+    {
+        m_glsl = false;
+        return;
+    }
     {
         glGetIntegerv(GL_MAJOR_VERSION, &m_gl_major_version);
         glGetIntegerv(GL_MINOR_VERSION, &m_gl_minor_version);
@@ -257,6 +263,28 @@ void CentralVideoSettings::init()
         }
 #endif
 
+        // Program binaries are core in OpenGL 4.1 and OpenGL ES 3.0, but
+        // they are useless if the driver does not support any format.
+        if (!GraphicsRestrictions::isDisabled(GraphicsRestrictions::GR_PROGRAM_BINARY) &&
+            m_glsl == true)
+        {
+#if !defined(USE_GLES2)
+            bool usable = hasGLExtension("GL_ARB_get_program_binary") ||
+                m_gl_major_version > 4 ||
+                (m_gl_major_version == 4 && m_gl_minor_version >= 1);
+#else
+            bool usable = true;
+#endif
+            GLint formats = 0;
+            if (usable)
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            if (formats > 0)
+            {
+                hasProgramBinary = true;
+                Log::info("GLDriver", "ARB Get Program Binary Present");
+            }
+        }
+
         // Only unset the high def textures if they are set as default. If the
         // user has enabled them (bit 1 set), then leave them enabled.
         if (GraphicsRestrictions::isDisabled(GraphicsRestrictions::GR_HIGHDEFINITION_TEXTURES) &&
@@ -460,4 +488,9 @@ bool CentralVideoSettings::isARBTextureBufferObjectUsable() const
     return hasTextureBufferObject;
 }
 
+bool CentralVideoSettings::isARBGetProgramBinaryUsable() const
+{
+    return hasProgramBinary;
+}
+
 #endif   // !SERVER_ONLY
@@ -49,12 +49,21 @@ private:
     bool hasBGRA;
     bool hasColorBufferFloat;
     bool hasTextureBufferObject;
+    bool hasProgramBinary;
     bool m_need_vertex_id_workaround;
+
+    /** Run without any GL context: a NULL device, no shaders, textures or
+     *  rendering. Only the simulation is updated. */
+    bool m_no_graphics = false;
 public:
     static bool m_supports_sp;
 
     void init();
     bool isGLSL() const;
+    // ------------------------------------------------------------------------
+    void setNoGraphics(bool no_graphics) { m_no_graphics = no_graphics; }
+    // ------------------------------------------------------------------------
+    bool isNoGraphics() const { return m_no_graphics; }
     unsigned getGLSLVersion() const;
 
     // Needs special handle ?
@@ -83,6 +92,7 @@ public:
     bool isEXTTextureFormatBGRA8888Usable() const;
     bool isEXTColorBufferFloatUsable() const;
     bool isARBTextureBufferObjectUsable() const;
+    bool isARBGetProgramBinaryUsable() const;
 
     // Are all required extensions available for feature support
     bool supportsComputeShadersFiltering() const;
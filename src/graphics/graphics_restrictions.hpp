@@ -66,6 +66,7 @@ namespace GraphicsRestrictions
         GR_NPOT_TEXTURES,
         GR_TEXTURE_BUFFER_OBJECT,
         GR_SYSTEM_SCREEN_KEYBOARD,
+        GR_PROGRAM_BINARY,
         GR_COUNT  /** MUST be last entry. */
     } ;
 
@@ -209,7 +209,8 @@ const char* IrrDriver::getGPUQueryPhaseName(unsigned q)
 void IrrDriver::reset()
 {
 #ifndef SERVER_ONLY
-    m_renderer->resetPostProcessing();
+    if (m_renderer)
+        m_renderer->resetPostProcessing();
 #endif
 }   // reset
 
@@ -307,6 +308,7 @@ void IrrDriver::initDevice()
     SIrrlichtCreationParameters params;
 
     // If --no-graphics option was used, the null device can still be used.
+    if (!CVS->isNoGraphics())
     {
         // This code is only executed once. No need to reload the video
         // modes every time the resolution changes.
@@ -421,7 +423,8 @@ void IrrDriver::initDevice()
     // pipeline doesn't work for them. For example some radeon drivers
     // support only GLSL 1.3 and it causes STK to crash. We should force to use
     // fixed pipeline in this case.
-    if ((GraphicsRestrictions::isDisabled(GraphicsRestrictions::GR_FORCE_LEGACY_DEVICE) ||
+    if (!CVS->isNoGraphics() &&
+        (GraphicsRestrictions::isDisabled(GraphicsRestrictions::GR_FORCE_LEGACY_DEVICE) ||
         (CVS->isGLSL() && !CentralVideoSettings::m_supports_sp)))
     {
         Log::warn("irr_driver", "Driver doesn't support shader-based pipeline. "
@@ -466,13 +469,17 @@ void IrrDriver::initDevice()
     m_actual_screen_size = m_video_driver->getCurrentRenderTargetSize();
 
 #ifndef SERVER_ONLY
-    if (!CVS->isGLSL())
+    // Without graphics there is no renderer, all scene nodes stay invisible
+    if (!CVS->isNoGraphics())
     {
-        Log::fatal("irr_driver",
-               "GLSL not supported by driver");
+        if (!CVS->isGLSL())
+        {
+            Log::fatal("irr_driver",
+                   "GLSL not supported by driver");
+        }
+        m_renderer = new ShaderBasedRenderer();
+        preloadShaders();
     }
-	m_renderer = new ShaderBasedRenderer();
-	preloadShaders();
 #endif
 
     if (UserConfigParams::m_shadows_resolution != 0 &&
@@ -493,7 +500,11 @@ void IrrDriver::initDevice()
     m_video_driver->endScene();
 
 #ifndef SERVER_ONLY
-    if (CVS->isGLSL())
+    if (CVS->isNoGraphics())
+    {
+        Log::info("irr_driver", "Running without graphics.");
+    }
+    else if (CVS->isGLSL())
     {
         Log::info("irr_driver", "GLSL supported.");
     }
@@ -1184,7 +1195,8 @@ scene::ISceneNode *IrrDriver::addSkyBox(const std::vector<video::ITexture*> &tex
 #ifndef SERVER_ONLY
     assert(texture.size() == 6);
 
-    m_renderer->addSkyBox(texture, spherical_harmonics_textures);
+    if (m_renderer)
+        m_renderer->addSkyBox(texture, spherical_harmonics_textures);
 
 #endif 
     return m_scene_manager->addSkyBoxSceneNode(texture[0], texture[1],
@@ -1196,7 +1208,8 @@ scene::ISceneNode *IrrDriver::addSkyBox(const std::vector<video::ITexture*> &tex
 void IrrDriver::suppressSkyBox()
 {
 #ifndef SERVER_ONLY
-    m_renderer->removeSkyBox();;
+    if (m_renderer)
+        m_renderer->removeSkyBox();
 #endif
 }   // suppressSkyBox
 
@@ -1326,7 +1339,8 @@ void IrrDriver::dropAllTextures(const scene::IMesh *mesh)
 void IrrDriver::onLoadWorld()
 {
 #ifndef SERVER_ONLY
-    m_renderer->onLoadWorld();
+    if (m_renderer)
+        m_renderer->onLoadWorld();
 #endif
 }   // onLoadWorld
 
@@ -1334,7 +1348,8 @@ void IrrDriver::onLoadWorld()
 void IrrDriver::onUnloadWorld()
 {
 #ifndef SERVER_ONLY
-    m_renderer->onUnloadWorld();
+    if (m_renderer)
+        m_renderer->onUnloadWorld();
 #endif
 }   // onUnloadWorld
 
@@ -1353,7 +1368,8 @@ void IrrDriver::setAmbientLight(const video::SColorf &light, bool force_SH_compu
     color.b = powf(color.b, 1.0f / 2.2f);
     
     m_scene_manager->setAmbientLight(color);
-    m_renderer->setAmbientLight(light, force_SH_computation);    
+    if (m_renderer)
+        m_renderer->setAmbientLight(light, force_SH_computation);
 #endif
 }   // setAmbientLight
 
@@ -1385,7 +1401,8 @@ void IrrDriver::minimalUpdate(float dt) {
     if (World::getWorld())
     {
 #ifndef SERVER_ONLY
-        m_renderer->minimalRender(dt);
+        if (m_renderer)
+            m_renderer->minimalRender(dt);
 #endif
     }
 }
@@ -312,7 +312,10 @@ public:
     unsigned int getRealTime() {return m_device->getTimer()->getRealTime(); }
     // ------------------------------------------------------------------------
     /** Use motion blur for a short time */
-    void giveBoost(unsigned int cam_index) { m_renderer->giveBoost(cam_index);}
+    void giveBoost(unsigned int cam_index)
+    {
+        if (m_renderer) m_renderer->giveBoost(cam_index);
+    }
     // ------------------------------------------------------------------------
     inline core::vector3df getWind()  {return m_wind->getWind();}
 
@@ -373,10 +376,13 @@ public:
     void addGlowingNode(scene::ISceneNode *n, float r = 1.0f, float g = 1.0f,
                         float b = 1.0f)
     {
-        m_renderer->addGlowingNode(n, r, g, b);
+        if (m_renderer) m_renderer->addGlowingNode(n, r, g, b);
     }
     // ------------------------------------------------------------------------
-    void clearGlowingNodes() { m_renderer->clearGlowingNodes(); }
+    void clearGlowingNodes()
+    {
+        if (m_renderer) m_renderer->clearGlowingNodes();
+    }
     // ------------------------------------------------------------------------
     void addForcedBloomNode(scene::ISceneNode *n, float power = 1)
     {
@@ -148,9 +148,7 @@ Material::Material(const XMLNode *node, bool deprecated)
     node->get("ignore",              &m_ignore             );
 
     node->get("max-speed",           &m_max_speed_fraction );
-    float f = stk_config->ticks2Time(m_slowdown_ticks);
-    node->get("slowdown-time",       &f                    );
-    m_slowdown_ticks = stk_config->time2Ticks(f);
+    node->get("slowdown-time",       &m_slowdown_time      );
     node->get("colorizable",         &m_colorizable        );
     node->get("colorization-factor", &m_colorization_factor);
     node->get("hue-settings",        &m_hue_settings       );
@@ -479,7 +477,7 @@ void Material::init()
     m_colorization_factor       = 0.0f;
     m_colorization_mask         = "";
     m_max_speed_fraction        = 1.0f;
-    m_slowdown_ticks            = stk_config->time2Ticks(1.0f);
+    m_slowdown_time             = 1.0f;
     m_zipper                    = false;
     m_zipper_duration           = -1.0f;
     m_zipper_fade_out_time      = -1.0f;
@@ -538,6 +536,15 @@ Material::~Material()
     unloadTexture();
 }   // ~Material
 
+//-----------------------------------------------------------------------------
+/** Returns how long it will take for a slowdown to take effect, in ticks of
+ *  the active race.
+ */
+int Material::getSlowDownTicks() const
+{
+    return stk_config->time2Ticks(m_slowdown_time);
+}   // getSlowDownTicks
+
 //-----------------------------------------------------------------------------
 
 void Material::unloadTexture()
@@ -152,8 +152,9 @@ private:
     /** Random generator for getting pre-defined hue */
     RandomGenerator m_random_hue;
 
-    /** How much the top speed is reduced per second. */
-    int              m_slowdown_ticks;
+    /** How much the top speed is reduced per second. Stored in seconds,
+     *  since materials are shared by races with different physics rates. */
+    float            m_slowdown_time;
 
     /** Maximum speed at which no more slow down occurs. */
     float            m_max_speed_fraction;
@@ -271,7 +272,7 @@ public:
     /** Returns how long it will take for a slowdown to take effect.
      *  It is the time it takes till the full slowdown applies to
      *  karts. So a short time will slowdown a kart much faster. */
-    int getSlowDownTicks() const { return m_slowdown_ticks;          }
+    int getSlowDownTicks() const;
     // ------------------------------------------------------------------------
     /** Returns true if this material is under some other mesh and therefore
      *  requires another raycast to find the surface it is under (used for
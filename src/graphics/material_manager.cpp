@@ -288,7 +288,7 @@ void MaterialManager::addSharedMaterial(const std::string& filename, bool deprec
 //-----------------------------------------------------------------------------
 bool MaterialManager::pushTempMaterial(const std::string& filename, bool deprecated)
 {
-    XMLNode *root = file_manager->createXMLTree(filename);
+    XMLNode *root = file_manager->createCachedXMLTree(filename);
     if(!root || root->getName()!="materials")
     {
         if(root) delete root;
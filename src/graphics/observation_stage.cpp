@@ -0,0 +1,308 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SERVER_ONLY
+
+#include "graphics/observation_stage.hpp"
+
+#include "graphics/central_settings.hpp"
+#include "graphics/irr_driver.hpp"
+#include "graphics/rtts.hpp"
+#include "graphics/texture_shader.hpp"
+#include "utils/objecttype.h"
+
+#include <ICameraSceneNode.h>
+
+#include <algorithm>
+
+// ============================================================================
+class ObservationColorShader : public TextureShader<ObservationColorShader, 1,
+                                                    core::vector2df, int, int>
+{
+public:
+    ObservationColorShader()
+    {
+        loadProgram(OBJECT, GL_VERTEX_SHADER, "screenquad.vert",
+                            GL_FRAGMENT_SHADER, "observation_color.frag");
+        assignUniforms("out_size", "area", "gray");
+        assignSamplerNames(0, "tex", ST_NEAREST_FILTERED);
+    }   // ObservationColorShader
+    // ------------------------------------------------------------------------
+    void render(GLuint tex, const core::vector2df &out_size, bool area,
+                bool gray)
+    {
+        setTextureUnits(tex);
+        drawFullScreenEffect(out_size, area ? 1 : 0, gray ? 1 : 0);
+    }   // render
+};   // ObservationColorShader
+
+// ============================================================================
+class ObservationDepthShader : public TextureShader<ObservationDepthShader, 1,
+                                                    core::vector2df, float,
+                                                    float, int>
+{
+public:
+    ObservationDepthShader()
+    {
+        loadProgram(OBJECT, GL_VERTEX_SHADER, "screenquad.vert",
+                            GL_FRAGMENT_SHADER, "observation_depth.frag");
+        assignUniforms("out_size", "zn", "zf", "linearize");
+        assignSamplerNames(0, "tex", ST_NEAREST_FILTERED);
+    }   // ObservationDepthShader
+    // ------------------------------------------------------------------------
+    void render(GLuint depth_stencil_texture, const core::vector2df &out_size,
+                float zn, float zf, bool linearize)
+    {
+        setTextureUnits(depth_stencil_texture);
+        drawFullScreenEffect(out_size, zn, zf, linearize ? 1 : 0);
+    }   // render
+};   // ObservationDepthShader
+
+// ============================================================================
+class ObservationLabelShader : public TextureShader<ObservationLabelShader, 1,
+                                                    core::vector2df, int, int>
+{
+public:
+    ObservationLabelShader()
+    {
+        loadProgram(OBJECT, GL_VERTEX_SHADER, "screenquad.vert",
+                            GL_FRAGMENT_SHADER, "observation_label.frag");
+        assignUniforms("out_size", "mode", "shift");
+        assignSamplerNames(0, "tex", ST_NEAREST_FILTERED);
+    }   // ObservationLabelShader
+    // ------------------------------------------------------------------------
+    void render(GLuint tex, const core::vector2df &out_size, bool mode,
+                int shift)
+    {
+        setTextureUnits(tex);
+        drawFullScreenEffect(out_size, mode ? 1 : 0, shift);
+    }   // render
+};   // ObservationLabelShader
+
+// ============================================================================
+ObservationStage::ObservationStage(unsigned int width, unsigned int height,
+                                   unsigned int stack_size, ColorOutput color,
+                                   DepthOutput depth, LabelOutput label,
+                                   Filter color_filter, Filter label_filter)
+                : m_width(width), m_height(height),
+                  m_stack_size(std::max(stack_size, 1u)),
+                  m_color_output(color), m_depth_output(depth),
+                  m_label_output(label), m_color_filter(color_filter),
+                  m_label_filter(label_filter)
+{
+    switch (m_color_output)
+    {
+    case COLOR_NONE: break;
+    case COLOR_RGB:
+        createOutput(&m_color, GL_RGBA8, GL_RGB, GL_UNSIGNED_BYTE); break;
+    case COLOR_GRAY:
+        createOutput(&m_color, GL_R8, GL_RED, GL_UNSIGNED_BYTE); break;
+    }
+    switch (m_depth_output)
+    {
+    case DEPTH_NONE: break;
+    case DEPTH_RAW:
+    case DEPTH_LINEAR:
+        createOutput(&m_depth, GL_R32F, GL_RED, GL_FLOAT); break;
+    case DEPTH_RAW_UINT16:
+        createOutput(&m_depth, GL_R16, GL_RED, GL_UNSIGNED_SHORT); break;
+    case DEPTH_LINEAR_HALF:
+        createOutput(&m_depth, GL_R16F, GL_RED, GL_HALF_FLOAT); break;
+    }
+    switch (m_label_output)
+    {
+    case LABEL_NONE: break;
+    case LABEL_INSTANCE:
+        createOutput(&m_label, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT);
+        break;
+    case LABEL_OBJECT_TYPE:
+        createOutput(&m_label, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE);
+        break;
+    }
+    if (m_stack_size > 1 && !(GLEW_VERSION_4_3 || GLEW_ARB_copy_image))
+        glGenFramebuffers(2, m_copy_fbo);
+    clear();
+}   // ObservationStage
+
+// ----------------------------------------------------------------------------
+ObservationStage::~ObservationStage()
+{
+    for (Output *out : { &m_color, &m_depth, &m_label })
+    {
+        if (out->m_fbo)
+            glDeleteFramebuffers(1, &out->m_fbo);
+        if (out->enabled())
+            glDeleteTextures(m_stack_size > 1 ? 2 : 1, out->m_texture);
+    }
+    if (m_copy_fbo[0])
+        glDeleteFramebuffers(2, m_copy_fbo);
+}   // ~ObservationStage
+
+// ----------------------------------------------------------------------------
+void ObservationStage::createOutput(Output *out, GLint internal_format,
+                                    GLenum format, GLenum type)
+{
+    // A single frame does not need a second texture to shift the stack
+    unsigned int n = m_stack_size > 1 ? 2 : 1;
+    glGenTextures(n, out->m_texture);
+    for (unsigned int i = 0; i < n; i++)
+    {
+        glBindTexture(GL_TEXTURE_2D_ARRAY, out->m_texture[i]);
+        if (CVS->isARBTextureStorageUsable())
+        {
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, internal_format, m_width,
+                           m_height, m_stack_size);
+        }
+        else
+        {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, internal_format, m_width,
+                         m_height, m_stack_size, 0, format, type, 0);
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+                        GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER,
+                        GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    glGenFramebuffers(1, &out->m_fbo);
+    out->m_format = format;
+    out->m_type = type;
+}   // createOutput
+
+// ----------------------------------------------------------------------------
+/** Shifts the frame stack of out by one frame and binds its newest layer as
+ *  render target. */
+void ObservationStage::bindOutput(Output *out)
+{
+    if (m_stack_size > 1)
+    {
+        GLuint src = out->m_texture[out->m_current];
+        out->m_current = 1 - out->m_current;
+        GLuint dst = out->m_texture[out->m_current];
+        if (GLEW_VERSION_4_3 || GLEW_ARB_copy_image)
+        {
+            glCopyImageSubData(src, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 1,
+                               dst, GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0,
+                               m_width, m_height, m_stack_size - 1);
+        }
+        else
+        {
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, m_copy_fbo[0]);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_copy_fbo[1]);
+            for (unsigned int i = 0; i + 1 < m_stack_size; i++)
+            {
+                glFramebufferTextureLayer(GL_READ_FRAMEBUFFER,
+                                          GL_COLOR_ATTACHMENT0, src, 0, i + 1);
+                glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER,
+                                          GL_COLOR_ATTACHMENT0, dst, 0, i);
+                glBlitFramebuffer(0, 0, m_width, m_height, 0, 0, m_width,
+                                  m_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, out->m_fbo);
+    glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                              out->getTexture(), 0, m_stack_size - 1);
+    GLenum buf = GL_COLOR_ATTACHMENT0;
+    glDrawBuffers(1, &buf);
+    glViewport(0, 0, m_width, m_height);
+}   // bindOutput
+
+// ----------------------------------------------------------------------------
+void ObservationStage::process(RTT *rtts,
+                               const irr::scene::ICameraSceneNode *camera)
+{
+    const core::vector2df out_size((float)m_width, (float)m_height);
+    // The stage runs in between the passes of the renderer, leave its state
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    const GLboolean depth_test = glIsEnabled(GL_DEPTH_TEST);
+    const GLboolean blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    if (m_color.enabled())
+    {
+        bindOutput(&m_color);
+        ObservationColorShader::getInstance()
+            ->render(rtts->getRenderTarget(RTT_COLOR), out_size,
+                     m_color_filter == FILTER_AREA,
+                     m_color_output == COLOR_GRAY);
+    }
+    if (m_depth.enabled())
+    {
+        bindOutput(&m_depth);
+        ObservationDepthShader::getInstance()
+            ->render(rtts->getDepthStencilTexture(), out_size,
+                     camera->getNearValue(), camera->getFarValue(),
+                     m_depth_output == DEPTH_LINEAR ||
+                     m_depth_output == DEPTH_LINEAR_HALF);
+    }
+    if (m_label.enabled())
+    {
+        bindOutput(&m_label);
+        ObservationLabelShader::getInstance()
+            ->render(rtts->getRenderTarget(RTT_LABEL), out_size,
+                     m_label_filter == FILTER_MODE,
+                     m_label_output == LABEL_OBJECT_TYPE ?
+                     OBJECT_TYPE_SHIFT : 0);
+    }
+    glUseProgram(0);
+    if (depth_test)
+        glEnable(GL_DEPTH_TEST);
+    if (blend)
+        glEnable(GL_BLEND);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    glBindFramebuffer(GL_FRAMEBUFFER, irr_driver->getDefaultFramebuffer());
+}   // process
+
+// ----------------------------------------------------------------------------
+void ObservationStage::clear()
+{
+    const GLboolean scissor_test = glIsEnabled(GL_SCISSOR_TEST);
+    glDisable(GL_SCISSOR_TEST);
+    const GLfloat zero_f[4] = { 0.f, 0.f, 0.f, 0.f };
+    const GLuint zero_ui[4] = { 0, 0, 0, 0 };
+    const GLenum buf = GL_COLOR_ATTACHMENT0;
+    for (Output *out : { &m_color, &m_depth, &m_label })
+    {
+        if (!out->enabled())
+            continue;
+        glBindFramebuffer(GL_FRAMEBUFFER, out->m_fbo);
+        glDrawBuffers(1, &buf);
+        for (unsigned int i = 0; i < (m_stack_size > 1 ? 2u : 1u); i++)
+        {
+            for (unsigned int layer = 0; layer < m_stack_size; layer++)
+            {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                          out->m_texture[i], 0, layer);
+                // Integer textures can only be cleared as integers
+                if (out->m_format == GL_RED_INTEGER)
+                    glClearBufferuiv(GL_COLOR, 0, zero_ui);
+                else
+                    glClearBufferfv(GL_COLOR, 0, zero_f);
+            }
+        }
+        out->m_current = 0;
+    }
+    if (scissor_test)
+        glEnable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_FRAMEBUFFER, irr_driver->getDefaultFramebuffer());
+}   // clear
+
+#endif   // !SERVER_ONLY
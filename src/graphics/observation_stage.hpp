@@ -0,0 +1,103 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_OBSERVATION_STAGE_HPP
+#define HEADER_OBSERVATION_STAGE_HPP
+
+#include "graphics/gl_headers.hpp"
+#include "utils/no_copy.hpp"
+
+#include <memory>
+
+class RTT;
+
+namespace irr
+{
+    namespace scene { class ICameraSceneNode; }
+}
+
+/** \brief Converts the output of a render target into the observations
+ *  handed to an agent, before they are read back to the CPU.
+ *  Each output (color, depth and instance labels) is drawn in a small
+ *  fullscreen pass into a texture of the requested format and size, flipped
+ *  such that the first row is the top of the image. Outputs set to NONE are
+ *  skipped.
+ *  Each output texture is an array of getStackSize() layers that holds the
+ *  last frames, oldest first. Stacked frames are shifted by one layer every
+ *  process(), using two textures in turn. All layers are zero until they
+ *  are filled by process(), see clear().
+ *  \ingroup graphics
+ */
+class ObservationStage : public NoCopy
+{
+public:
+    enum ColorOutput { COLOR_NONE, COLOR_RGB, COLOR_GRAY };
+    enum DepthOutput { DEPTH_NONE, DEPTH_RAW, DEPTH_RAW_UINT16,
+                       DEPTH_LINEAR, DEPTH_LINEAR_HALF };
+    enum LabelOutput { LABEL_NONE, LABEL_INSTANCE, LABEL_OBJECT_TYPE };
+    /** AREA averages all pixels of the footprint (color only), MODE picks the
+     *  most frequent label (labels only). Depth is always sampled NEAREST. */
+    enum Filter { FILTER_NEAREST, FILTER_AREA, FILTER_MODE };
+
+    /** A converted output texture array and the pixel format to read it
+     *  with. */
+    struct Output
+    {
+        GLuint m_texture[2] = { 0, 0 };
+        GLuint m_fbo = 0;
+        unsigned int m_current = 0;
+        GLenum m_format = 0, m_type = 0;
+        bool enabled() const { return m_texture[0] != 0; }
+        GLuint getTexture() const { return m_texture[m_current]; }
+    };
+
+private:
+    unsigned int m_width, m_height, m_stack_size;
+    ColorOutput m_color_output;
+    DepthOutput m_depth_output;
+    LabelOutput m_label_output;
+    Filter m_color_filter, m_label_filter;
+    Output m_color, m_depth, m_label;
+    /** Framebuffers to shift the stack with, if glCopyImageSubData is
+     *  missing. */
+    GLuint m_copy_fbo[2] = { 0, 0 };
+
+    void createOutput(Output *out, GLint internal_format, GLenum format,
+                      GLenum type);
+    void bindOutput(Output *out);
+
+public:
+    ObservationStage(unsigned int width, unsigned int height,
+                     unsigned int stack_size, ColorOutput color,
+                     DepthOutput depth, LabelOutput label,
+                     Filter color_filter = FILTER_NEAREST,
+                     Filter label_filter = FILTER_NEAREST);
+    ~ObservationStage();
+    /** Convert the content of rtts, camera provides the depth range. */
+    void process(RTT *rtts, const irr::scene::ICameraSceneNode *camera);
+    /** Clear all stacked frames, e.g. when a race (re)starts. */
+    void clear();
+
+    const Output& getColor() const { return m_color; }
+    const Output& getDepth() const { return m_depth; }
+    const Output& getLabel() const { return m_label; }
+    unsigned int getWidth()  const { return m_width;  }
+    unsigned int getHeight() const { return m_height; }
+    unsigned int getStackSize() const { return m_stack_size; }
+};   // ObservationStage
+
+#endif
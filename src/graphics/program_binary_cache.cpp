@@ -0,0 +1,225 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SERVER_ONLY
+
+#include "graphics/program_binary_cache.hpp"
+
+#include "graphics/central_settings.hpp"
+#include "graphics/shader_files_manager.hpp"
+#include "io/file_manager.hpp"
+#include "utils/log.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <unistd.h>
+#endif
+
+namespace
+{
+    /** Header of a cached program binary. */
+    struct BinaryHeader
+    {
+        char     m_magic[4];
+        uint32_t m_format;
+        uint32_t m_length;
+    };
+
+    const char BINARY_MAGIC[4] = { 'S', 'T', 'K', 'P' };
+
+    // ------------------------------------------------------------------------
+    /** Adds a string (and its terminating 0, to separate strings) to a
+     *  FNV-1a hash. */
+    void hashString(uint64_t *hash, const char *s, size_t size)
+    {
+        for (size_t i = 0; i <= size; i++)
+            *hash = (*hash ^ (unsigned char)(i < size ? s[i] : 0))
+                  * 1099511628211ULL;
+    }   // hashString
+
+    // ------------------------------------------------------------------------
+    void hashString(uint64_t *hash, const std::string &s)
+    {
+        hashString(hash, s.c_str(), s.size());
+    }   // hashString
+
+    // ------------------------------------------------------------------------
+    void hashGLString(uint64_t *hash, GLenum name)
+    {
+        const char *s = (const char*)glGetString(name);
+        if (s)
+            hashString(hash, s, strlen(s));
+        else
+            hashString(hash, "", 0);
+    }   // hashGLString
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Returns true if linked programs are stored in and loaded from the cache.
+ */
+bool ProgramBinaryCache::isEnabled()
+{
+    return CVS->isARBGetProgramBinaryUsable() &&
+           !file_manager->getCachedShadersDir().empty();
+}   // isEnabled
+
+// ----------------------------------------------------------------------------
+/** Returns the key of a program in the cache, or an empty string if the cache
+ *  is disabled.
+ *  \param files Type and file name of all shaders of the program.
+ *  \param extra Other state that changes the linked program (e.g. transform
+ *         feedback varyings).
+ */
+std::string ProgramBinaryCache::getKey(const ShaderFileList &files,
+                                       const std::string &extra)
+{
+    if (!isEnabled())
+        return "";
+
+    uint64_t hash = 14695981039346656037ULL;
+    hashGLString(&hash, GL_VENDOR);
+    hashGLString(&hash, GL_RENDERER);
+    hashGLString(&hash, GL_VERSION);
+    hashGLString(&hash, GL_SHADING_LANGUAGE_VERSION);
+    ShaderFilesManager *sfm = ShaderFilesManager::getInstance();
+    for (const auto &file : files)
+    {
+        hashString(&hash, std::to_string(file.first));
+        hashString(&hash, sfm->getShaderSource(sfm->getFullPath(file.second),
+                                               file.first));
+    }
+    hashString(&hash, extra);
+
+    char key[32];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+    return key;
+}   // getKey
+
+// ----------------------------------------------------------------------------
+/** Returns the file in which the program with the given key is cached. */
+std::string ProgramBinaryCache::getFile(const std::string &key)
+{
+    return file_manager->getCachedShadersDir() + key + ".bin";
+}   // getFile
+
+// ----------------------------------------------------------------------------
+/** Loads a cached program. If there is no cached program (or the driver
+ *  rejects it) the program needs to be compiled and linked, and it is
+ *  marked so that save() can retrieve its binary after linking.
+ *  \param program The program object to load the binary into.
+ *  \param key Key of the program (see getKey).
+ *  \return True if the program was loaded and is linked.
+ */
+bool ProgramBinaryCache::load(GLuint program, const std::string &key)
+{
+    if (key.empty())
+        return false;
+
+    const std::string file = getFile(key);
+    bool linked = false;
+    FILE *f = fopen(file.c_str(), "rb");
+    if (f)
+    {
+        BinaryHeader header;
+        std::vector<char> binary;
+        if (fread(&header, sizeof(header), 1, f) == 1 &&
+            memcmp(header.m_magic, BINARY_MAGIC, 4) == 0 &&
+            header.m_length > 0)
+        {
+            binary.resize(header.m_length);
+            if (fread(binary.data(), header.m_length, 1, f) != 1)
+                binary.clear();
+        }
+        fclose(f);
+
+        if (!binary.empty())
+        {
+            glProgramBinary(program, header.m_format, binary.data(),
+                            (GLsizei)binary.size());
+            GLint result = GL_FALSE;
+            glGetProgramiv(program, GL_LINK_STATUS, &result);
+            linked = result == GL_TRUE;
+        }
+        // Clear any error of a rejected binary, it is compiled instead.
+        glGetError();
+        if (!linked)
+        {
+            Log::info("ProgramBinaryCache", "Cached program '%s' was "
+                      "rejected, compiling it.", file.c_str());
+            remove(file.c_str());
+        }
+    }
+
+    if (!linked)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    }
+    return linked;
+}   // load
+
+// ----------------------------------------------------------------------------
+/** Stores the binary of a linked program in the cache. The file is written
+ *  under a temporary name first, so that concurrent processes never read a
+ *  partially written binary.
+ *  \param program A successfully linked program.
+ *  \param key Key of the program (see getKey).
+ */
+void ProgramBinaryCache::save(GLuint program, const std::string &key)
+{
+    if (key.empty())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+    if (glGetError() != GL_NO_ERROR || length <= 0)
+        return;
+
+    BinaryHeader header;
+    memcpy(header.m_magic, BINARY_MAGIC, 4);
+    header.m_format = format;
+    header.m_length = (uint32_t)length;
+
+    const std::string file = getFile(key);
+    std::string tmp = file + "." + std::to_string(getpid()) + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    bool written = f && fwrite(&header, sizeof(header), 1, f) == 1 &&
+                   fwrite(binary.data(), length, 1, f) == 1;
+    if (f)
+        fclose(f);
+    if (!written || rename(tmp.c_str(), file.c_str()) != 0)
+    {
+        Log::warn("ProgramBinaryCache", "Can not write program '%s'.",
+                  file.c_str());
+        remove(tmp.c_str());
+    }
+}   // save
+
+#endif   // !SERVER_ONLY
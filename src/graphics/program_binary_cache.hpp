@@ -0,0 +1,61 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef SERVER_ONLY
+
+#ifndef HEADER_PROGRAM_BINARY_CACHE_HPP
+#define HEADER_PROGRAM_BINARY_CACHE_HPP
+
+#include "graphics/gl_headers.hpp"
+#include "utils/no_copy.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/** \brief Caches linked shader programs on disk.
+ *  Compiling and linking all shaders is a large part of the startup time,
+ *  especially with software drivers. After a program is linked its binary is
+ *  stored in the cached shaders directory, and later processes load it with
+ *  glProgramBinary instead of compiling the shaders. The key of a program is
+ *  a hash of the driver (vendor, renderer and version) and of the complete
+ *  source of all its shaders, so a changed shader or driver never loads a
+ *  stale binary. If the driver rejects a binary, the program is compiled
+ *  from source as usual.
+ *  \ingroup graphics
+ */
+class ProgramBinaryCache : public NoCopy
+{
+public:
+    /** A list of shader types and shader file names. */
+    typedef std::vector<std::pair<unsigned, std::string> > ShaderFileList;
+
+private:
+    static std::string getFile(const std::string &key);
+
+public:
+    static bool        isEnabled();
+    static std::string getKey(const ShaderFileList &files,
+                              const std::string &extra = "");
+    static bool        load(GLuint program, const std::string &key);
+    static void        save(GLuint program, const std::string &key);
+};   // ProgramBinaryCache
+
+#endif
+
+#endif   // !SERVER_ONLY
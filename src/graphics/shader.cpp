@@ -39,6 +39,20 @@ int ShaderBase::loadTFBProgram(const std::string &shader_name,
                                unsigned varying_count)
 {
     m_program = glCreateProgram();
+
+    // The varyings are part of the linked program, so they are in the key
+    ProgramBinaryCache::ShaderFileList files;
+    getShaderFiles(&files, GL_VERTEX_SHADER, shader_name);
+#ifdef USE_GLES2
+    getShaderFiles(&files, GL_FRAGMENT_SHADER, "white.frag");
+#endif
+    std::string varying_names;
+    for (unsigned i = 0; i < varying_count; i++)
+        varying_names += std::string(varyings[i]) + " ";
+    const std::string key = ProgramBinaryCache::getKey(files, varying_names);
+    if (ProgramBinaryCache::load(m_program, key))
+        return m_program;
+
     loadAndAttachShader(GL_VERTEX_SHADER, shader_name);
 #ifdef USE_GLES2
     loadAndAttachShader(GL_FRAGMENT_SHADER, "white.frag");
@@ -59,6 +73,8 @@ int ShaderBase::loadTFBProgram(const std::string &shader_name,
         Log::error("ShaderBase", error_message);
         delete[] error_message;
     }
+    else
+        ProgramBinaryCache::save(m_program, key);
 
     glGetError();
 
@@ -21,6 +21,7 @@
 #define HEADER_SHADER_HPP
 
 #include "graphics/gl_headers.hpp"
+#include "graphics/program_binary_cache.hpp"
 #include "graphics/shader_files_manager.hpp"
 #include "graphics/shared_gpu_objects.hpp"
 #include "utils/singleton.hpp"
@@ -86,6 +87,32 @@ protected:
     {
         loadAndAttachShader(shader_type, std::string(name), args...);
     }   // loadAndAttachShader
+    // ------------------------------------------------------------------------
+    /** Ends recursion. */
+    template<typename ... Types>
+    void getShaderFiles(ProgramBinaryCache::ShaderFileList *files)
+    {
+        return;
+    }   // getShaderFiles
+    // ------------------------------------------------------------------------
+    /** Collects the type and name of all shaders of a program, which are
+     *  used as key in the program binary cache. */
+    template<typename ... Types>
+    void getShaderFiles(ProgramBinaryCache::ShaderFileList *files,
+                        GLint shader_type, const std::string &name,
+                        Types ... args)
+    {
+        files->emplace_back(shader_type, name);
+        getShaderFiles(files, args...);
+    }   // getShaderFiles
+    // ------------------------------------------------------------------------
+    /** Convenience interface using const char. */
+    template<typename ... Types>
+    void getShaderFiles(ProgramBinaryCache::ShaderFileList *files,
+                        GLint shader_type, const char *name, Types ... args)
+    {
+        getShaderFiles(files, shader_type, std::string(name), args...);
+    }   // getShaderFiles
 
 public:
         ShaderBase();
@@ -359,12 +386,20 @@ public:
     }   // Shader
 
     // ------------------------------------------------------------------------
-    /** Load a list of shaders and links them all together.
+    /** Load a list of shaders and links them all together. The shaders are
+     *  only compiled if the linked program is not in the program binary
+     *  cache.
      */
     template<typename ... Types>
     void loadProgram(AttributeType type, Types ... args)
     {
         m_program = glCreateProgram();
+        ProgramBinaryCache::ShaderFileList files;
+        getShaderFiles(&files, args...);
+        const std::string key = ProgramBinaryCache::getKey(files);
+        if (ProgramBinaryCache::load(m_program, key))
+            return;
+
         loadAndAttachShader(args...);
         glLinkProgram(m_program);
 
@@ -381,6 +416,8 @@ public:
             Log::error("Shader", error_message);
             delete[] error_message;
         }
+        else
+            ProgramBinaryCache::save(m_program, key);
         // After linking all shaders can be detached
         for (auto shader : m_shaders)
         {
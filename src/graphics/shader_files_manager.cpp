@@ -118,20 +118,17 @@ void ShaderFilesManager::readFile(const std::string& file,
 }
 
 // ----------------------------------------------------------------------------
-/** Loads a single shader. This is NOT cached, use addShaderFile for that.
- *  \param file Filename of the shader to load.
+/** Returns the complete source of a shader, as it is passed to the driver.
+ *  The source is only built once per file.
+ *  \param full_path Full path of the shader file.
  *  \param type Type of the shader.
  */
-ShaderFilesManager::SharedShader ShaderFilesManager::loadShader
+const std::string& ShaderFilesManager::getShaderSource
     (const std::string& full_path, unsigned type)
 {
-    GLuint* ss_ptr = new GLuint;
-    *ss_ptr = glCreateShader(type);
-    SharedShader ss(ss_ptr, [](GLuint* ss)
-    {
-        glDeleteShader(*ss);
-        delete ss;
-    });
+    auto it = m_shader_sources.find(full_path);
+    if (it != m_shader_sources.end())
+        return it->second;
 
     std::ostringstream code;
 #if !defined(USE_GLES2)
@@ -210,9 +207,28 @@ ShaderFilesManager::SharedShader ShaderFilesManager::loadShader
 
     readFile(full_path, code);
 
+    return m_shader_sources[full_path] = code.str();
+}   // getShaderSource
+
+// ----------------------------------------------------------------------------
+/** Loads a single shader. This is NOT cached, use addShaderFile for that.
+ *  \param file Filename of the shader to load.
+ *  \param type Type of the shader.
+ */
+ShaderFilesManager::SharedShader ShaderFilesManager::loadShader
+    (const std::string& full_path, unsigned type)
+{
+    GLuint* ss_ptr = new GLuint;
+    *ss_ptr = glCreateShader(type);
+    SharedShader ss(ss_ptr, [](GLuint* ss)
+    {
+        glDeleteShader(*ss);
+        delete ss;
+    });
+
     Log::info("ShaderFilesManager", "Compiling shader: %s",
         full_path.c_str());
-    const std::string &source  = code.str();
+    const std::string &source  = getShaderSource(full_path, type);
     char const *source_pointer = source.c_str();
     int len                    = (int)source.size();
     glShaderSource(*ss, 1, &source_pointer, &len);
@@ -269,10 +285,7 @@ ShaderFilesManager::SharedShader ShaderFilesManager::addShaderFile
 ShaderFilesManager::SharedShader ShaderFilesManager::getShaderFile
     (const std::string &file, unsigned type)
 {
-    const std::string full_path = (file.find('/') != std::string::npos ||
-        file.find('\\') != std::string::npos) ?
-        file : std::string(file_manager->getFileSystem()->getAbsolutePath
-        (file_manager->getShadersDir().c_str()).c_str()) + file;
+    const std::string full_path = getFullPath(file);
     // found in cache
     auto it = m_shader_files_loaded.find(full_path);
     if (it != m_shader_files_loaded.end())
@@ -282,4 +295,17 @@ ShaderFilesManager::SharedShader ShaderFilesManager::getShaderFile
     return addShaderFile(full_path, type);
 }   // getShaderFile
 
+// ----------------------------------------------------------------------------
+/** Returns the full path of a shader file, which is used as key in all
+ *  caches. Names without a directory are searched in the shaders directory.
+ *  \param file Filename of the shader.
+ */
+std::string ShaderFilesManager::getFullPath(const std::string &file)
+{
+    return (file.find('/') != std::string::npos ||
+        file.find('\\') != std::string::npos) ?
+        file : std::string(file_manager->getFileSystem()->getAbsolutePath
+        (file_manager->getShadersDir().c_str()).c_str()) + file;
+}   // getFullPath
+
 #endif   // !SERVER_ONLY
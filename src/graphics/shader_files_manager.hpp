@@ -41,6 +41,12 @@ private:
      */
     std::unordered_map<std::string, SharedShader> m_shader_files_loaded;
 
+    /**
+     * Map from a filename in full path to the complete source of the shader
+     * (with version, defines, header and includes), as it is compiled.
+     */
+    std::unordered_map<std::string, std::string> m_shader_sources;
+
     // ------------------------------------------------------------------------
     const std::string& getHeader();
     // ------------------------------------------------------------------------
@@ -89,6 +95,11 @@ public:
     SharedShader loadShader(const std::string& full_path, unsigned type);
     // ------------------------------------------------------------------------
     SharedShader getShaderFile(const std::string& file, unsigned type);
+    // ------------------------------------------------------------------------
+    std::string getFullPath(const std::string& file);
+    // ------------------------------------------------------------------------
+    const std::string& getShaderSource(const std::string& full_path,
+                                       unsigned type);
 
 };   // ShaderFilesManager
 
@@ -34,6 +34,7 @@
 #include "modes/world.hpp"
 #include "tracks/quad.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/mini_glm.hpp"
 
 /** Creates the slip stream object
@@ -180,6 +181,38 @@ void SlipStream::reset()
     m_kart->increaseMaxSpeed(MaxSpeed::MS_INCREASE_SLIPSTREAM, 0, 0, 0, 0);
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves the collected slipstream time and the active bonus. The speed
+ *  increase itself is part of the MaxSpeed state of the kart.
+ */
+void SlipStream::saveState(Snapshot *s) const
+{
+    s->add(m_slipstream_mode);
+    s->add(m_slipstream_time);
+    s->add(m_bonus_time);
+    s->add(m_bonus_active);
+    s->add(m_current_target_id);
+    s->add(m_previous_target_id);
+    s->add(m_speed_increase_ticks);
+    s->add(m_speed_increase_duration);
+    s->add(m_target_kart ? (int)m_target_kart->getWorldKartId() : -1);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+void SlipStream::restoreState(Snapshot *s)
+{
+    s->get(&m_slipstream_mode);
+    s->get(&m_slipstream_time);
+    s->get(&m_bonus_time);
+    s->get(&m_bonus_active);
+    s->get(&m_current_target_id);
+    s->get(&m_previous_target_id);
+    s->get(&m_speed_increase_ticks);
+    s->get(&m_speed_increase_duration);
+    int target = s->get<int>();
+    m_target_kart = target >= 0 ? World::getWorld()->getKart(target) : NULL;
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Creates the mesh for the slipstream effect. This function creates a
  *  first a series of circles (with a certain number of vertices each and
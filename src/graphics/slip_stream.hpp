@@ -40,6 +40,7 @@ namespace SP
 class AbstractKart;
 class Quad;
 class Material;
+class Snapshot;
 
 /**
   * \ingroup graphics
@@ -125,6 +126,8 @@ public:
                  ~SlipStream  ();
     void         reset();
     void         update(int ticks);
+    void         saveState(Snapshot *s) const;
+    void         restoreState(Snapshot *s);
     bool         isSlipstreamReady() const;
     void         updateSpeedIncrease();
     // ------------------------------------------------------------------------
@@ -17,6 +17,7 @@
 
 #include "graphics/sp/sp_shader.hpp"
 #include "graphics/central_settings.hpp"
+#include "graphics/program_binary_cache.hpp"
 #include "graphics/shader_files_manager.hpp"
 #include "graphics/sp/sp_base.hpp"
 #include "graphics/sp/sp_uniform_assigner.hpp"
@@ -57,6 +58,7 @@ SPShader::SPShader(const std::string& name,
 #endif
     
     memset(m_program, 0, 12);
+    m_loaded = false;
     m_init_function(this);
 }
 // ----------------------------------------------------------------------------
@@ -68,42 +70,59 @@ void SPShader::addShaderFile(const std::string& name, GLint shader_type,
     {
         m_program[rp] = glCreateProgram();
     }
-    auto shader_file = ShaderFilesManager::getInstance()
-        ->getShaderFile(name, shader_type);
-    if (shader_file)
-    {
-        m_shader_files.push_back(shader_file);
-        glAttachShader(m_program[rp], *shader_file);
-    }
+    m_pending_files[rp].emplace_back(shader_type, name);
 #endif
 }   // addShaderFile
 
 // ----------------------------------------------------------------------------
+/** Links the shader files added to a pass. The files are only compiled if
+ *  the linked program is not in the program binary cache.
+ */
 void SPShader::linkShaderFiles(RenderPass rp)
 {
 #ifndef SERVER_ONLY
-    glLinkProgram(m_program[rp]);
-    GLint result = GL_FALSE;
-    glGetProgramiv(m_program[rp], GL_LINK_STATUS, &result);
-    if (result == GL_FALSE)
+    m_loaded = true;
+    const std::string key = ProgramBinaryCache::getKey(m_pending_files[rp]);
+    const bool cached = ProgramBinaryCache::load(m_program[rp], key);
+    GLint result = GL_TRUE;
+    if (!cached)
     {
-        Log::error("SPShader", "Error when linking shader %s in pass %d",
-            m_name.c_str(), (int)rp);
-        int info_length;
-        glGetProgramiv(m_program[rp], GL_INFO_LOG_LENGTH, &info_length);
-        char *error_message = new char[info_length];
-        glGetProgramInfoLog(m_program[rp], info_length, NULL, error_message);
-        Log::error("SPShader", error_message);
-        delete[] error_message;
-    }
-    // After linking all shaders can be detached
-    GLuint shaders[10] = {};
-    GLsizei count = 0;
-    glGetAttachedShaders(m_program[rp], 10, &count, shaders);
-    for (unsigned i = 0; i < (unsigned)count; i++)
-    {
-        glDetachShader(m_program[rp], shaders[i]);
+        for (auto& file : m_pending_files[rp])
+        {
+            auto shader_file = ShaderFilesManager::getInstance()
+                ->getShaderFile(file.second, file.first);
+            if (shader_file)
+            {
+                m_shader_files.push_back(shader_file);
+                glAttachShader(m_program[rp], *shader_file);
+            }
+        }
+        glLinkProgram(m_program[rp]);
+        glGetProgramiv(m_program[rp], GL_LINK_STATUS, &result);
+        if (result == GL_FALSE)
+        {
+            Log::error("SPShader", "Error when linking shader %s in pass %d",
+                m_name.c_str(), (int)rp);
+            int info_length;
+            glGetProgramiv(m_program[rp], GL_INFO_LOG_LENGTH, &info_length);
+            char *error_message = new char[info_length];
+            glGetProgramInfoLog(m_program[rp], info_length, NULL,
+                error_message);
+            Log::error("SPShader", error_message);
+            delete[] error_message;
+        }
+        else
+            ProgramBinaryCache::save(m_program[rp], key);
+        // After linking all shaders can be detached
+        GLuint shaders[10] = {};
+        GLsizei count = 0;
+        glGetAttachedShaders(m_program[rp], 10, &count, shaders);
+        for (unsigned i = 0; i < (unsigned)count; i++)
+        {
+            glDetachShader(m_program[rp], shaders[i]);
+        }
     }
+    m_pending_files[rp].clear();
     if (result == GL_FALSE)
     {
         glDeleteProgram(m_program[rp]);
@@ -358,6 +377,7 @@ void SPShader::unload()
         m_unuse_function[rp] = nullptr;
     }
     m_shader_files.clear();
+    m_loaded = false;
 #endif
 }   // unload
 
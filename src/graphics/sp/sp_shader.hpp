@@ -90,6 +90,13 @@ private:
 
     std::vector<std::shared_ptr<GLuint> > m_shader_files;
 
+    /** Type and name of the shader files added to each pass, which are
+     *  compiled in linkShaderFiles unless the program is cached. */
+    std::vector<std::pair<unsigned, std::string> > m_pending_files[RP_COUNT];
+
+    /** True once the init function linked the programs of this shader. */
+    bool m_loaded;
+
     GLuint m_program[RP_COUNT];
 
     std::map<unsigned, unsigned> m_samplers[RP_COUNT];
@@ -224,7 +231,7 @@ public:
     // ------------------------------------------------------------------------
     void init()
     {
-        if (!m_shader_files.empty())
+        if (m_loaded)
         {
             return;
         }
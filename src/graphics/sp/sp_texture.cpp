@@ -44,12 +44,18 @@ extern "C"
 }
 #endif
 
+#include <algorithm>
 #include <numeric>
+#include <thread>
 
 #if !defined(MOBILE_STK)
 static const uint8_t CACHE_VERSION = 1;
 #endif
 
+/** Minimum number of rows of 4x4 blocks compressed by one thread, smaller
+ *  images (and mipmaps) are not worth starting threads for. */
+static const int MIN_BLOCK_ROWS_PER_THREAD = 16;
+
 namespace SP
 {
 // ----------------------------------------------------------------------------
@@ -671,45 +677,70 @@ void SPTexture::squishCompressImage(uint8_t* rgba, int width, int height,
 {
 #if !(defined(SERVER_ONLY) || defined(MOBILE_STK))
     // This function is copied from CompressImage in libsquish to avoid omp
-    // if enabled by shared libsquish, because we are already using
-    // multiple thread
-    for (int y = 0; y < height; y += 4)
-    {
-        // initialise the block output
-        uint8_t* target_block = reinterpret_cast<uint8_t*>(blocks);
-        target_block += ((y >> 2) * ((width + 3) >> 2)) * 16;
-        for (int x = 0; x < width; x += 4)
+    // if enabled by shared libsquish. Rows of blocks are independent, so
+    // large images are split into ranges of rows compressed on all cores.
+    auto compress_rows = [=](int first_y, int last_y)
+    {
+        for (int y = first_y; y < last_y; y += 4)
         {
-            // build the 4x4 block of pixels
-            uint8_t source_rgba[16 * 4];
-            uint8_t* target_pixel = source_rgba;
-            int mask = 0;
-            for (int py = 0; py < 4; py++)
+            // initialise the block output
+            uint8_t* target_block = reinterpret_cast<uint8_t*>(blocks);
+            target_block += ((y >> 2) * ((width + 3) >> 2)) * 16;
+            for (int x = 0; x < width; x += 4)
             {
-                for (int px = 0; px < 4; px++)
+                // build the 4x4 block of pixels
+                uint8_t source_rgba[16 * 4];
+                uint8_t* target_pixel = source_rgba;
+                int mask = 0;
+                for (int py = 0; py < 4; py++)
                 {
-                    // get the source pixel in the image
-                    int sx = x + px;
-                    int sy = y + py;
-                    // enable if we're in the image
-                    if (sx < width && sy < height)
+                    for (int px = 0; px < 4; px++)
                     {
-                        // copy the rgba value
-                        uint8_t* source_pixel = rgba + pitch * sy + 4 * sx;
-                        memcpy(target_pixel, source_pixel, 4);
-                        // enable this pixel
-                        mask |= (1 << (4 * py + px));
+                        // get the source pixel in the image
+                        int sx = x + px;
+                        int sy = y + py;
+                        // enable if we're in the image
+                        if (sx < width && sy < height)
+                        {
+                            // copy the rgba value
+                            uint8_t* source_pixel =
+                                rgba + pitch * sy + 4 * sx;
+                            memcpy(target_pixel, source_pixel, 4);
+                            // enable this pixel
+                            mask |= (1 << (4 * py + px));
+                        }
+                        // advance to the next pixel
+                        target_pixel += 4;
                     }
-                    // advance to the next pixel
-                    target_pixel += 4;
                 }
+                // compress it into the output
+                squish::CompressMasked(source_rgba, mask, target_block,
+                                       flags);
+                // advance
+                target_block += 16;
             }
-            // compress it into the output
-            squish::CompressMasked(source_rgba, mask, target_block, flags);
-            // advance
-            target_block += 16;
         }
+    };
+
+    const int block_rows = (height + 3) >> 2;
+    const int num_threads = std::min(
+        (int)std::thread::hardware_concurrency(),
+        block_rows / MIN_BLOCK_ROWS_PER_THREAD);
+    if (num_threads <= 1)
+    {
+        compress_rows(0, height);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    const int rows_per_thread = (block_rows + num_threads - 1) / num_threads;
+    for (int first = 0; first < block_rows; first += rows_per_thread)
+    {
+        threads.emplace_back(compress_rows, first * 4,
+            std::min((first + rows_per_thread) * 4, height));
     }
+    for (std::thread& t : threads)
+        t.join();
 #endif
 }   // squishCompressImage
 
@@ -85,7 +85,10 @@ video::ITexture* STKTexManager::getTexture(const std::string& path,
     {
         new_texture = new STKTexture(full_path.empty() ? path : full_path,
             tc, no_upload);
-        if (new_texture->getOpenGLTextureName() == 0 && !no_upload)
+        // Without graphics no texture is uploaded, but all are kept to
+        // avoid looking them up again
+        if (new_texture->getOpenGLTextureName() == 0 && !no_upload &&
+            !CVS->isNoGraphics())
         {
             const char* name = new_texture->getName().getPtr();
             if (!m_texture_error_message.empty())
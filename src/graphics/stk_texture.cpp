@@ -84,6 +84,18 @@ void STKTexture::reload(bool no_upload, uint8_t* preload_data,
                         video::IImage* preload_img)
 {
 #ifndef SERVER_ONLY
+    if (CVS->isNoGraphics())
+    {
+        // Nothing is drawn without graphics, so don't decode the image
+        m_orig_size.Width = 2;
+        m_orig_size.Height = 2;
+        m_size = m_orig_size;
+        delete[] preload_data;
+        if (preload_img)
+            preload_img->drop();
+        return;
+    }
+
 
     video::IImage* orig_img = NULL;
     uint8_t* data = preload_data;
@@ -22,6 +22,7 @@
 
 #include "graphics/irr_driver.hpp"
 #include "graphics/material_manager.hpp"
+#include "io/xml_cache.hpp"
 #include "karts/kart_properties_manager.hpp"
 #include "tracks/track_manager.hpp"
 #include "utils/command_line.hpp"
@@ -272,6 +273,9 @@ FileManager::FileManager()
     checkAndCreateAddonsDir();
     checkAndCreateScreenshotDir();
     checkAndCreateCachedTexturesDir();
+    checkAndCreateCachedBVHDir();
+    checkAndCreateCachedXMLDir();
+    checkAndCreateCachedShadersDir();
     checkAndCreateGPDir();
 
     redirectOutput();
@@ -490,6 +494,16 @@ XMLNode *FileManager::createXMLTree(const std::string &filename)
     }
 }   // createXMLTree
 
+//-----------------------------------------------------------------------------
+/** Reads in a XML file and converts it into a XMLNode tree. The parsed tree
+ *  is cached on disk (see XMLCache), use this for large files of tracks.
+ *  \param filename Name of the XML file to read.
+ */
+XMLNode *FileManager::createCachedXMLTree(const std::string &filename)
+{
+    return XMLCache::createXMLTree(filename);
+}   // createCachedXMLTree
+
 //-----------------------------------------------------------------------------
 /** Reads in XML from a string and converts it into a XMLNode tree.
  *  \param content the string containing the XML content.
@@ -724,6 +738,33 @@ std::string FileManager::getCachedTexturesDir() const
     return m_cached_textures_dir;
 }   // getCachedTexturesDir
 
+//-----------------------------------------------------------------------------
+/** Returns the directory in which the collision trees of tracks are cached.
+ *  Empty if the directory could not be created.
+ */
+std::string FileManager::getCachedBVHDir() const
+{
+    return m_cached_bvh_dir;
+}   // getCachedBVHDir
+
+//-----------------------------------------------------------------------------
+/** Returns the directory in which parsed XML trees of tracks are cached.
+ *  Empty if the directory could not be created.
+ */
+std::string FileManager::getCachedXMLDir() const
+{
+    return m_cached_xml_dir;
+}   // getCachedXMLDir
+
+//-----------------------------------------------------------------------------
+/** Returns the directory in which linked shader programs are cached.
+ *  Empty if the directory could not be created.
+ */
+std::string FileManager::getCachedShadersDir() const
+{
+    return m_cached_shaders_dir;
+}   // getCachedShadersDir
+
 //-----------------------------------------------------------------------------
 /** Returns the directory in which user-defined grand prix should be stored.
  */
@@ -1040,6 +1081,84 @@ void FileManager::checkAndCreateCachedTexturesDir()
 
 }   // checkAndCreateCachedTexturesDir
 
+// ----------------------------------------------------------------------------
+/** Creates the directory for cached collision trees. This will set
+*  m_cached_bvh_dir with the appropriate path, or clear it (which disables
+*  the cache) if the directory can not be created.
+*/
+void FileManager::checkAndCreateCachedBVHDir()
+{
+#if defined(WIN32) || defined(__CYGWIN__)
+    m_cached_bvh_dir = m_user_config_dir + "cached-bvh/";
+#elif defined(__APPLE__)
+    m_cached_bvh_dir = getenv("HOME");
+    m_cached_bvh_dir += "/Library/Application Support/SuperTuxKart/CachedBVH/";
+#else
+    m_cached_bvh_dir = checkAndCreateLinuxDir("XDG_CACHE_HOME", "supertuxkart", ".cache/", ".");
+    m_cached_bvh_dir += "cached-bvh/";
+#endif
+
+    if (!checkAndCreateDirectory(m_cached_bvh_dir))
+    {
+        Log::error("FileManager", "Can not create cached bvh directory '%s', "
+            "collision trees will not be cached.", m_cached_bvh_dir.c_str());
+        m_cached_bvh_dir = "";
+    }
+
+}   // checkAndCreateCachedBVHDir
+
+// ----------------------------------------------------------------------------
+/** Creates the directory for cached XML trees. This will set
+*  m_cached_xml_dir with the appropriate path, or clear it (which disables
+*  the cache) if the directory can not be created.
+*/
+void FileManager::checkAndCreateCachedXMLDir()
+{
+#if defined(WIN32) || defined(__CYGWIN__)
+    m_cached_xml_dir = m_user_config_dir + "cached-xml/";
+#elif defined(__APPLE__)
+    m_cached_xml_dir = getenv("HOME");
+    m_cached_xml_dir += "/Library/Application Support/SuperTuxKart/CachedXML/";
+#else
+    m_cached_xml_dir = checkAndCreateLinuxDir("XDG_CACHE_HOME", "supertuxkart", ".cache/", ".");
+    m_cached_xml_dir += "cached-xml/";
+#endif
+
+    if (!checkAndCreateDirectory(m_cached_xml_dir))
+    {
+        Log::error("FileManager", "Can not create cached xml directory '%s', "
+            "xml files will not be cached.", m_cached_xml_dir.c_str());
+        m_cached_xml_dir = "";
+    }
+
+}   // checkAndCreateCachedXMLDir
+
+// ----------------------------------------------------------------------------
+/** Creates the directory for cached shader program binaries. This will set
+*  m_cached_shaders_dir with the appropriate path, or clear it (which
+*  disables the cache) if the directory can not be created.
+*/
+void FileManager::checkAndCreateCachedShadersDir()
+{
+#if defined(WIN32) || defined(__CYGWIN__)
+    m_cached_shaders_dir = m_user_config_dir + "cached-shaders/";
+#elif defined(__APPLE__)
+    m_cached_shaders_dir = getenv("HOME");
+    m_cached_shaders_dir += "/Library/Application Support/SuperTuxKart/CachedShaders/";
+#else
+    m_cached_shaders_dir = checkAndCreateLinuxDir("XDG_CACHE_HOME", "supertuxkart", ".cache/", ".");
+    m_cached_shaders_dir += "cached-shaders/";
+#endif
+
+    if (!checkAndCreateDirectory(m_cached_shaders_dir))
+    {
+        Log::error("FileManager", "Can not create cached shaders directory '%s', "
+            "shader programs will not be cached.", m_cached_shaders_dir.c_str());
+        m_cached_shaders_dir = "";
+    }
+
+}   // checkAndCreateCachedShadersDir
+
 // ----------------------------------------------------------------------------
 /** Creates the directories for user-defined grand prix. This will set m_gp_dir
  *  with the appropriate path.
@@ -92,6 +92,15 @@ private:
     /** Directory where resized textures are cached. */
     std::string       m_cached_textures_dir;
 
+    /** Directory where the collision trees of tracks are cached. */
+    std::string       m_cached_bvh_dir;
+
+    /** Directory where parsed XML trees of tracks are cached. */
+    std::string       m_cached_xml_dir;
+
+    /** Directory where linked shader program binaries are cached. */
+    std::string       m_cached_shaders_dir;
+
     /** Directory where user-defined grand prix are stored. */
     std::string       m_gp_dir;
 
@@ -121,6 +130,9 @@ private:
     void              checkAndCreateAddonsDir();
     void              checkAndCreateScreenshotDir();
     void              checkAndCreateCachedTexturesDir();
+    void              checkAndCreateCachedBVHDir();
+    void              checkAndCreateCachedXMLDir();
+    void              checkAndCreateCachedShadersDir();
     void              checkAndCreateGPDir();
     void              discoverPaths();
     void              addAssetsSearchPath();
@@ -141,10 +153,14 @@ public:
     static void       setStdoutDir(const std::string &dir);
     io::IXMLReader   *createXMLReader(const std::string &filename);
     XMLNode          *createXMLTree(const std::string &filename);
+    XMLNode          *createCachedXMLTree(const std::string &filename);
     XMLNode          *createXMLTreeFromString(const std::string & content);
 
     std::string       getScreenshotDir() const;
     std::string       getCachedTexturesDir() const;
+    std::string       getCachedBVHDir() const;
+    std::string       getCachedXMLDir() const;
+    std::string       getCachedShadersDir() const;
     std::string       getGPDir() const;
     bool              checkAndCreateDirectory(const std::string &path);
     bool              checkAndCreateDirectoryP(const std::string &path);
@@ -0,0 +1,324 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "io/xml_cache.hpp"
+
+#include "io/file_manager.hpp"
+#include "io/xml_node.hpp"
+#include "utils/log.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef WIN32
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+    /** Header of a cached XML tree. */
+    struct TreeHeader
+    {
+        char     m_magic[4];
+        uint32_t m_version;
+        uint32_t m_wchar_size;
+        uint32_t m_num_nodes;
+        uint64_t m_source_size;
+    };
+
+    const char     TREE_MAGIC[4] = { 'S', 'T', 'K', 'X' };
+    /** Version of the format, increase it when the format changes. */
+    const uint32_t TREE_VERSION  = 1;
+
+    // ------------------------------------------------------------------------
+    void writeU32(std::string *out, uint32_t value)
+    {
+        out->append((const char*)&value, sizeof(value));
+    }   // writeU32
+
+    // ------------------------------------------------------------------------
+    /** Appends the number of elements and the elements of an array. The
+     *  data is padded to 4 bytes, so that all values (and the characters of
+     *  wide strings) are aligned in the mapped file. */
+    void writeArray(std::string *out, const void *data, size_t count,
+                    size_t element_size)
+    {
+        writeU32(out, (uint32_t)count);
+        out->append((const char*)data, count * element_size);
+        out->append((4 - out->size() % 4) % 4, '\0');
+    }   // writeArray
+
+    // ------------------------------------------------------------------------
+    bool readU32(const char **pos, const char *end, uint32_t *value)
+    {
+        if (end - *pos < (ptrdiff_t)sizeof(uint32_t))
+            return false;
+        memcpy(value, *pos, sizeof(uint32_t));
+        *pos += sizeof(uint32_t);
+        return true;
+    }   // readU32
+
+    // ------------------------------------------------------------------------
+    /** Reads an array written by writeArray.
+     *  \return Pointer to the first element, or NULL if the data is
+     *          truncated. */
+    const char *readArray(const char **pos, const char *end, uint32_t *count,
+                          size_t element_size)
+    {
+        if (!readU32(pos, end, count))
+            return NULL;
+        size_t size = ((size_t)*count * element_size + 3) & ~(size_t)3;
+        if ((size_t)(end - *pos) < size)
+            return NULL;
+        const char *data = *pos;
+        *pos += size;
+        return data;
+    }   // readArray
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Reads a XML file and converts it into a XMLNode tree, using the cached
+ *  tree if the file was loaded before.
+ *  \param filename Name of the XML file to read.
+ *  \return The tree, or NULL if the file does not exist or can't be parsed.
+ */
+XMLNode *XMLCache::createXMLTree(const std::string &filename)
+{
+    const std::string &dir = file_manager->getCachedXMLDir();
+    io::IReadFile *f = dir.empty() ? NULL :
+        file_manager->getFileSystem()->createAndOpenFile(filename.c_str());
+    if (!f)
+        return file_manager->createXMLTree(filename);
+
+    std::vector<char> source(f->getSize());
+    bool read = !source.empty() &&
+                f->read(source.data(), (u32)source.size()) == (s32)source.size();
+    f->drop();
+    if (!read)
+        return file_manager->createXMLTree(filename);
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (char c : source)
+        hash = (hash ^ (unsigned char)c) * 1099511628211ULL;
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx.xml.bin", (unsigned long long)hash);
+    const std::string file = dir + name;
+
+    XMLNode *root = load(file, filename, source.size());
+    if (root)
+        return root;
+    root = file_manager->createXMLTree(filename);
+    if (root)
+        save(root, file, source.size());
+    return root;
+}   // createXMLTree
+
+// ----------------------------------------------------------------------------
+/** Appends a node and all its children (in pre-order) to the binary tree.
+ *  \param node The node to write.
+ *  \param out The binary tree.
+ *  \param num_nodes Incremented by the number of nodes written.
+ */
+void XMLCache::writeNode(const XMLNode *node, std::string *out,
+                         uint32_t *num_nodes)
+{
+    (*num_nodes)++;
+    writeArray(out, node->m_name.data(), node->m_name.size(), 1);
+    writeU32(out, (uint32_t)node->m_attributes.size());
+    for (const auto &attribute : node->m_attributes)
+    {
+        writeArray(out, attribute.first.data(), attribute.first.size(), 1);
+        writeArray(out, attribute.second.c_str(), attribute.second.size(),
+                   sizeof(wchar_t));
+    }
+    writeU32(out, (uint32_t)node->m_nodes.size());
+    for (const XMLNode *child : node->m_nodes)
+        writeNode(child, out, num_nodes);
+}   // writeNode
+
+// ----------------------------------------------------------------------------
+/** Creates a node and all its children from the binary tree.
+ *  \param pos Position of the node in the binary tree, advanced past the
+ *         node and all its children.
+ *  \param end End of the binary tree.
+ *  \param filename Name of the XML file, used in error messages.
+ *  \param num_nodes Incremented by the number of nodes read.
+ *  \return The node, or NULL if the binary tree is invalid.
+ */
+XMLNode *XMLCache::readNode(const char **pos, const char *end,
+                            const std::string &filename, uint32_t *num_nodes)
+{
+    uint32_t count;
+    const char *data = readArray(pos, end, &count, 1);
+    if (!data)
+        return NULL;
+
+    XMLNode *node = new XMLNode();
+    node->m_name.assign(data, count);
+    node->m_file_name = filename;
+    (*num_nodes)++;
+
+    uint32_t num_attributes;
+    bool valid = readU32(pos, end, &num_attributes);
+    for (uint32_t i = 0; valid && i < num_attributes; i++)
+    {
+        uint32_t value_count;
+        const char *name = readArray(pos, end, &count, 1);
+        const char *value = name ? readArray(pos, end, &value_count,
+                                             sizeof(wchar_t))
+                                 : NULL;
+        valid = value != NULL;
+        if (valid)
+        {
+            node->m_attributes[std::string(name, count)] =
+                core::stringw((const wchar_t*)value, value_count);
+        }
+    }
+
+    uint32_t num_children;
+    valid = valid && readU32(pos, end, &num_children);
+    for (uint32_t i = 0; valid && i < num_children; i++)
+    {
+        XMLNode *child = readNode(pos, end, filename, num_nodes);
+        valid = child != NULL;
+        if (valid)
+            node->m_nodes.push_back(child);
+    }
+
+    if (!valid)
+    {
+        delete node;
+        return NULL;
+    }
+    return node;
+}   // readNode
+
+// ----------------------------------------------------------------------------
+/** Writes a tree to the cache. The file is written under a temporary name
+ *  first, so that concurrent processes never read a partially written tree.
+ *  \param root Root of the tree.
+ *  \param file The cache file.
+ *  \param source_size Size of the XML source of the tree.
+ */
+void XMLCache::save(const XMLNode *root, const std::string &file,
+                    uint64_t source_size)
+{
+    TreeHeader header;
+    memcpy(header.m_magic, TREE_MAGIC, 4);
+    header.m_version     = TREE_VERSION;
+    header.m_wchar_size  = (uint32_t)sizeof(wchar_t);
+    header.m_num_nodes   = 0;
+    header.m_source_size = source_size;
+
+    std::string out((const char*)&header, sizeof(header));
+    writeNode(root, &out, &header.m_num_nodes);
+    memcpy(&out[0], &header, sizeof(header));
+
+    std::string tmp = file + "." + std::to_string(getpid()) + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    bool written = f && fwrite(out.data(), out.size(), 1, f) == 1;
+    if (f)
+        fclose(f);
+    if (!written || rename(tmp.c_str(), file.c_str()) != 0)
+    {
+        Log::warn("XMLCache", "Can not write '%s'.", file.c_str());
+        remove(tmp.c_str());
+    }
+}   // save
+
+// ----------------------------------------------------------------------------
+/** Loads a tree from the cache. On posix systems the file is mapped instead
+ *  of read.
+ *  \param file The cache file.
+ *  \param filename Name of the XML file of the tree.
+ *  \param source_size Size of the XML source of the tree.
+ *  \return The tree, or NULL if the file does not exist or is invalid.
+ */
+XMLNode *XMLCache::load(const std::string &file, const std::string &filename,
+                        uint64_t source_size)
+{
+#ifdef WIN32
+    FILE *f = fopen(file.c_str(), "rb");
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<uint32_t> buffer((size + 3) / 4);
+    const char *data = (const char*)buffer.data();
+    bool read = size >= (long)sizeof(TreeHeader) &&
+                fread(buffer.data(), size, 1, f) == 1;
+    fclose(f);
+    if (!read)
+        return NULL;
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(TreeHeader))
+    {
+        close(fd);
+        return NULL;
+    }
+    size_t size = st.st_size;
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+        return NULL;
+    const char *data = (const char*)mapped;
+#endif
+
+    XMLNode *root = NULL;
+    TreeHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.m_magic, TREE_MAGIC, 4) == 0 &&
+        header.m_version == TREE_VERSION &&
+        header.m_wchar_size == sizeof(wchar_t) &&
+        header.m_source_size == source_size)
+    {
+        const char *pos = data + sizeof(header);
+        const char *end = data + size;
+        uint32_t num_nodes = 0;
+        root = readNode(&pos, end, filename, &num_nodes);
+        if (root && (pos != end || num_nodes != header.m_num_nodes))
+        {
+            delete root;
+            root = NULL;
+        }
+    }
+
+#ifndef WIN32
+    munmap(mapped, size);
+#endif
+    if (!root)
+    {
+        Log::warn("XMLCache", "Ignoring invalid cached tree '%s'.",
+                  file.c_str());
+        remove(file.c_str());
+    }
+    return root;
+}   // load
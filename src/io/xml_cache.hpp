@@ -0,0 +1,60 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef HEADER_XML_CACHE_HPP
+#define HEADER_XML_CACHE_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstdint>
+#include <string>
+
+class XMLNode;
+
+/** \brief Caches parsed XML trees of tracks on disk.
+ *  Tracks store their scene, drive graph, navmesh and materials in large
+ *  XML files, and parsing them (irrlicht converts every file to wide
+ *  characters before tokenizing it) is a noticeable part of loading a
+ *  track. The first time a file is loaded, the tree is written in a compact
+ *  binary format: all nodes in pre-order, each with its name, attributes
+ *  (stored as wide strings exactly like in XMLNode) and number of children.
+ *  Later loads map that file and only copy the strings into a new tree.
+ *  The cache file is named after a hash of the XML source, and its header
+ *  stores the format version and the size of the source, so a changed file
+ *  or format never loads a stale tree.
+ *  \ingroup io
+ */
+class XMLCache : public NoCopy
+{
+private:
+    static void     writeNode(const XMLNode *node, std::string *out,
+                              uint32_t *num_nodes);
+    static XMLNode *readNode(const char **pos, const char *end,
+                             const std::string &filename,
+                             uint32_t *num_nodes);
+    static void     save(const XMLNode *root, const std::string &file,
+                         uint64_t source_size);
+    static XMLNode *load(const std::string &file, const std::string &filename,
+                         uint64_t source_size);
+
+public:
+    static XMLNode *createXMLTree(const std::string &filename);
+};   // XMLCache
+
+#endif
@@ -58,6 +58,10 @@ private:
 
     std::string                          m_file_name;
 
+    /** Creates an empty node, used by XMLCache to build cached trees. */
+    XMLNode() {}
+    friend class XMLCache;
+
 public:
          LEAK_CHECK();
          XMLNode(io::IXMLReader *xml);
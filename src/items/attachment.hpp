@@ -32,6 +32,7 @@ namespace irr
 
 class AbstractKart;
 class ItemState;
+class Snapshot;
 
 /** This objects is permanently available in a kart and stores information
  *  about addons. If a kart has no attachment, this object will have the
@@ -112,6 +113,8 @@ public:
 
     void  update(int ticks);
     void  handleCollisionWithKart(AbstractKart *other);
+    void  saveState(Snapshot *s) const;
+    void  restoreState(Snapshot *s);
     void  set (AttachmentType type, int ticks,
                AbstractKart *previous_kart=NULL,
                bool set_by_rewind_parachute = false);
@@ -23,6 +23,7 @@
 #include "io/xml_node.hpp"
 #include "karts/abstract_kart.hpp"
 #include "modes/linear_world.hpp"
+#include "utils/snapshot.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -212,3 +213,17 @@ void Bowling::onFireFlyable()
     // should not live forever, auto-destruct after 20 seconds
     m_max_lifespan = stk_config->time2Ticks(20);
 }   // onFireFlyable
+
+// ----------------------------------------------------------------------------
+void Bowling::saveState(Snapshot *s) const
+{
+    Flyable::saveState(s);
+    s->add(m_has_hit_kart);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void Bowling::restoreState(Snapshot *s)
+{
+    Flyable::restoreState(s);
+    s->get(&m_has_hit_kart);
+}   // restoreState
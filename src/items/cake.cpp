@@ -24,6 +24,7 @@
 #include "io/xml_node.hpp"
 #include "karts/abstract_kart.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -167,3 +168,17 @@ void Cake::onFireFlyable()
     m_body->clearForces();
     m_body->applyTorque(btVector3(5.0f, -3.0f, 7.0f));
 }   // onFireFlyable
+
+// ----------------------------------------------------------------------------
+void Cake::saveState(Snapshot *s) const
+{
+    Flyable::saveState(s);
+    s->add(m_initial_velocity);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void Cake::restoreState(Snapshot *s)
+{
+    Flyable::restoreState(s);
+    m_initial_velocity = s->getVec3();
+}   // restoreState
@@ -42,6 +42,7 @@
 #include "physics/physics.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/vs.hpp"
 #include "utils/objecttype.h"
@@ -668,6 +669,33 @@ void Flyable::onFireFlyable()
     m_force_updown = m_st_force_updown[m_type];
 }   // onFireFlyable
 
+// ----------------------------------------------------------------------------
+/** Saves the rigid body and the timers of this flyable. Subclasses add their
+ *  own state.
+ */
+void Flyable::saveState(Snapshot *s) const
+{
+    Moveable::saveState(s);
+    s->add(m_has_hit_something);
+    s->add(m_ticks_since_thrown);
+    s->add(m_owner_has_temporary_immunity);
+    s->add(m_speed);
+    s->add(m_max_lifespan);
+    s->add(m_created_ticks);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void Flyable::restoreState(Snapshot *s)
+{
+    Moveable::restoreState(s);
+    s->get(&m_has_hit_something);
+    s->get(&m_ticks_since_thrown);
+    s->get(&m_owner_has_temporary_immunity);
+    s->get(&m_speed);
+    s->get(&m_max_lifespan);
+    s->get(&m_created_ticks);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /* Call when deleting the flyable locally and save the deleted world ticks. */
 void Flyable::onDeleteFlyable()
@@ -41,6 +41,7 @@ class HitEffect;
 class PhysicalObject;
 class XMLNode;
 class RenderInfo;
+class Snapshot;
 
 /**
   * \ingroup items
@@ -223,7 +224,7 @@ public:
     /** Enables/disables adjusting ov velocity depending on height above
      *  terrain. Missiles can 'follow the terrain' with this adjustment,
      *  but gravity will basically be disabled.                          */
-    bool         hasHit      () { return m_has_hit_something; }
+    bool         hasHit      () const { return m_has_hit_something; }
     // ------------------------------------------------------------------------
     /** Indicates that something was hit and that this object must
      *  be removed. */
@@ -253,6 +254,9 @@ public:
     // ------------------------------------------------------------------------
     virtual void onDeleteFlyable();
     // ------------------------------------------------------------------------
+    virtual void saveState(Snapshot *s) const OVERRIDE;
+    virtual void restoreState(Snapshot *s) OVERRIDE;
+    // ------------------------------------------------------------------------
     void setCreatedTicks(int ticks)                { m_created_ticks = ticks; }
     
     void setObjectId(uint32_t id);
@@ -26,10 +26,12 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/controller/spare_tire_ai.hpp"
 #include "modes/easter_egg_hunt.hpp"
+#include "modes/world.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/arena_graph.hpp"
 #include "tracks/arena_node.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 
 #include <IMesh.h>
@@ -459,6 +461,102 @@ void ItemManager::reset()
     m_switch_ticks = -1;
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves the state of all items, including the item slots that are free
+ *  (the slot an item is inserted into depends on them), and the random
+ *  engine used for item placement.
+ */
+void ItemManager::saveState(Snapshot *s) const
+{
+    std::ostringstream random_engine;
+    random_engine << m_random_engine;
+    s->addString(random_engine.str());
+    s->add(m_switch_ticks);
+    s->add((uint32_t)m_all_items.size());
+    for (const ItemState *item : m_all_items)
+    {
+        s->add(item != NULL);
+        if (!item) continue;
+        s->add(item->m_type);
+        s->add(item->m_original_type);
+        s->add(item->m_ticks_till_return);
+        s->add(item->m_deactive_ticks);
+        s->add(item->m_used_up_counter);
+        s->add(item->m_xyz);
+        s->add(item->m_original_rotation);
+        s->add(item->m_previous_owner
+               ? (int)item->m_previous_owner->getWorldKartId() : -1);
+    }
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the items written by saveState. Items dropped after the
+ *  snapshot was taken are deleted, items used up since then are created
+ *  again in their original slot.
+ */
+void ItemManager::restoreState(Snapshot *s)
+{
+    std::istringstream random_engine(s->getString());
+    random_engine >> m_random_engine;
+    s->get(&m_switch_ticks);
+    unsigned int n = s->get<uint32_t>();
+    while (m_all_items.size() > n)
+    {
+        if (m_all_items.back())
+            deleteItem(m_all_items.back());
+        m_all_items.pop_back();
+    }
+    m_all_items.resize(n, NULL);
+
+    World *world = World::getWorld();
+    for (unsigned int i = 0; i < n; i++)
+    {
+        ItemState *item = m_all_items[i];
+        if (!s->get<bool>())
+        {
+            if (item) deleteItem(item);
+            continue;
+        }
+        ItemState::ItemType type = s->get<ItemState::ItemType>();
+        ItemState::ItemType original_type = s->get<ItemState::ItemType>();
+        int ticks_till_return = s->get<int>();
+        int deactive_ticks = s->get<int>();
+        int used_up_counter = s->get<int>();
+        Vec3 xyz = s->getVec3();
+        btQuaternion rotation = s->getQuat();
+        int owner_id = s->get<int>();
+        const AbstractKart *owner = owner_id >= 0
+                                  ? world->getKart(owner_id) : NULL;
+
+        // The slot may have been freed and reused by a newly dropped item.
+        if (item && (item->m_xyz != xyz || item->m_previous_owner != owner))
+        {
+            deleteItem(item);
+            item = NULL;
+        }
+        if (!item)
+        {
+            ItemState::ItemType mesh_type = type;
+            if (type == ItemState::ITEM_BUBBLEGUM && owner &&
+                owner->getIdent() == "nolok")
+                mesh_type = ItemState::ITEM_BUBBLEGUM_NOLOK;
+            Vec3 normal = quatRotate(rotation, Vec3(0.0f, 1.0f, 0.0f));
+            Item *new_item = new Item(type, xyz, normal,
+                                      m_item_mesh[mesh_type],
+                                      m_item_lowres_mesh[mesh_type], owner);
+            m_all_items[i] = new_item;
+            new_item->setItemId(i);
+            insertItemInQuad(new_item);
+            item = new_item;
+        }
+        item->setType(type);
+        item->m_original_type     = original_type;
+        item->m_ticks_till_return = ticks_till_return;
+        item->m_deactive_ticks    = deactive_ticks;
+        item->m_used_up_counter   = used_up_counter;
+    }
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Updates all items, and handles switching items back if the switch time
  *  is over.
@@ -574,7 +672,9 @@ void ItemManager::switchItemsInternal(std::vector<ItemState*> &all_items)
     // if the items are already switched (m_switch_ticks >=0)
     // then switch back, and set m_switch_ticks to -1 to indicate
     // that the items are now back to normal.
-    m_switch_ticks = m_switch_ticks < 0 ? stk_config->m_item_switch_ticks : -1;
+    m_switch_ticks = m_switch_ticks < 0
+                   ? stk_config->time2Ticks(stk_config->m_item_switch_time)
+                   : -1;
 
 }   // switchItems
 
@@ -38,6 +38,7 @@
 #include <vector>
 
 class Kart;
+class Snapshot;
 class STKPeer;
 
 /**
@@ -56,6 +57,8 @@ private:
     static std::mt19937 m_random_engine;
 
     static uint32_t m_random_seed;
+
+    friend class RaceContext;
 protected:
     /** The instance of ItemManager while a race is on. */
     static std::shared_ptr<ItemManager> m_item_manager;
@@ -152,6 +155,8 @@ public:
     void           updateGraphics  (float dt);
     void           checkItemHit    (AbstractKart* kart);
     void           reset           ();
+    void           saveState       (Snapshot *s) const;
+    void           restoreState    (Snapshot *s);
     virtual void   collectedItem   (ItemState *item, AbstractKart *kart);
     virtual void   switchItems     ();
     bool           randomItemsForArena(const AlignedArray<btTransform>& pos);
@@ -30,6 +30,7 @@
 
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -68,6 +69,20 @@ void Powerup::update(int ticks)
 {
 }   // update
 
+//-----------------------------------------------------------------------------
+void Powerup::saveState(Snapshot *s) const
+{
+    s->add(m_type);
+    s->add(m_number);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+void Powerup::restoreState(Snapshot *s)
+{
+    s->get(&m_type);
+    s->get(&m_number);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Sets the collected items. The number of items is increased if the same
  *  item is currently collected, otherwise replaces the existing item. It also
@@ -28,6 +28,7 @@
 
 class AbstractKart;
 class ItemState;
+class Snapshot;
 
 /**
   * \ingroup items
@@ -53,6 +54,8 @@ public:
     void            use          ();
     void            hitBonusBox (const ItemState &item);
     void            update(int ticks);
+    void            saveState(Snapshot *s) const;
+    void            restoreState(Snapshot *s);
 
     /** Returns the number of powerups. */
     int             getNum       () const {return m_number;}
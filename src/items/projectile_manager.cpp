@@ -30,6 +30,7 @@
 #include "karts/controller/controller.hpp"
 #include "modes/world.hpp"
 
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 
 #include <typeinfo>
@@ -61,6 +62,48 @@ void ProjectileManager::cleanup()
     m_active_hit_effects.clear();
 }   // cleanup
 
+// -----------------------------------------------------------------------------
+/** Saves all bowling balls and cakes in flight. Rubber balls and plungers
+ *  (which keep spline and rubber band state) are not saved, and disappear
+ *  when the snapshot is restored.
+ */
+void ProjectileManager::saveState(Snapshot *s) const
+{
+    std::vector<const Flyable*> saved;
+    for (auto &p : m_active_projectiles)
+    {
+        if ((p->getType() == PowerupManager::POWERUP_BOWLING ||
+             p->getType() == PowerupManager::POWERUP_CAKE) &&
+            !p->hasHit() && !p->hasAnimation())
+            saved.push_back(p.get());
+    }
+    s->add((uint32_t)saved.size());
+    for (const Flyable *f : saved)
+    {
+        s->add(f->getType());
+        s->add(f->getOwner()->getWorldKartId());
+        f->saveState(s);
+    }
+}   // saveState
+
+// -----------------------------------------------------------------------------
+/** Removes all flyables and fires the saved ones again from their owner,
+ *  then moves them to their saved state.
+ */
+void ProjectileManager::restoreState(Snapshot *s)
+{
+    cleanup();
+    unsigned int n = s->get<uint32_t>();
+    for (unsigned int i = 0; i < n; i++)
+    {
+        PowerupManager::PowerupType type =
+            s->get<PowerupManager::PowerupType>();
+        AbstractKart *owner = World::getWorld()->getKart(s->get<unsigned int>());
+        std::shared_ptr<Flyable> f = newProjectile(owner, type);
+        f->restoreState(s);
+    }
+}   // restoreState
+
 // -----------------------------------------------------------------------------
 /** Called once per rendered frame. It is used to only update any graphical
  *  effects, and calls updateGraphics in any flyable objects.
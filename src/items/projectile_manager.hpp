@@ -36,6 +36,7 @@ namespace irr
 class AbstractKart;
 class Flyable;
 class HitEffect;
+class Snapshot;
 class Track;
 class Vec3;
 
@@ -59,6 +60,8 @@ public:
                     ~ProjectileManager() {}
     void             loadData         ();
     void             cleanup          ();
+    void             saveState        (Snapshot *s) const;
+    void             restoreState     (Snapshot *s);
     void             update           (int ticks);
     void             updateGraphics   (float dt);
     void             removeTextures   ();
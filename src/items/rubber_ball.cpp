@@ -41,7 +41,7 @@ float RubberBall::m_st_squash_duration;
 float RubberBall::m_st_squash_slowdown;
 float RubberBall::m_st_target_distance;
 float RubberBall::m_st_target_max_angle;
-int16_t RubberBall::m_st_delete_ticks;
+float RubberBall::m_st_delete_time;
 float RubberBall::m_st_max_height_difference;
 float RubberBall::m_st_fast_ping_distance;
 float RubberBall::m_st_early_target_factor;
@@ -193,7 +193,8 @@ void RubberBall::computeTarget()
                 Log::debug("[RubberBall]",
                            "ball %d removed because owner is target.", m_id);
 #endif
-                m_delete_ticks = m_st_delete_ticks;
+                m_delete_ticks =
+                    (int16_t)stk_config->time2Ticks(m_st_delete_time);
             }
             return;
         }
@@ -206,7 +207,7 @@ void RubberBall::computeTarget()
     Log::debug("[RubberBall]" "ball %d removed because no more active target.",
                m_id);
 #endif
-    m_delete_ticks = m_st_delete_ticks;
+    m_delete_ticks = (int16_t)stk_config->time2Ticks(m_st_delete_time);
     m_target       = m_owner;
 }   // computeTarget
 
@@ -282,7 +283,7 @@ void RubberBall::init(const XMLNode &node, scene::IMesh *rubberball)
     m_st_min_interpolation_distance =  30.0f;
     m_st_target_distance            =  50.0f;
     m_st_target_max_angle           =  25.0f;
-    m_st_delete_ticks               = (int16_t)stk_config->time2Ticks(10.0f);
+    m_st_delete_time                =  10.0f;
     m_st_max_height_difference      =  10.0f;
     m_st_fast_ping_distance         =  50.0f;
     m_st_early_target_factor        =   1.0f;
@@ -306,10 +307,8 @@ void RubberBall::init(const XMLNode &node, scene::IMesh *rubberball)
     if(!node.get("target-distance", &m_st_target_distance))
         Log::warn("powerup",
                   "No target-distance specified for basket ball.");
-    float f;
-    if(!node.get("delete-time", &f))
+    if(!node.get("delete-time", &m_st_delete_time))
         Log::warn("powerup", "No delete-time specified for basket ball.");
-    m_st_delete_ticks = stk_config->time2Ticks(f);
     if(!node.get("target-max-angle", &m_st_target_max_angle))
         Log::warn("powerup", "No target-max-angle specified for basket ball.");
     m_st_target_max_angle *= DEGREE_TO_RAD;
@@ -774,7 +773,8 @@ void RubberBall::updateDistanceToTarget()
         // original target, and start deleting it.
         if(m_distance_to_target > 0.9f * Track::getCurrentTrack()->getTrackLength())
         {
-            m_delete_ticks = m_st_delete_ticks;
+            m_delete_ticks =
+                (int16_t)stk_config->time2Ticks(m_st_delete_time);
 #ifdef PRINT_BALL_REMOVE_INFO
             Log::debug("[RubberBall]", "ball %d lost target (overtook?).",
                         m_id);
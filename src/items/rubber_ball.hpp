@@ -78,8 +78,8 @@ private:
 
     /** If the ball overtakes its target or starts to aim at the kart which
      *  originally shot the rubber ball, after this amount of time the
-     *  ball will be deleted. */
-    static int16_t m_st_delete_ticks;
+     *  ball will be deleted (in seconds). */
+    static float m_st_delete_time;
 
     /** If the ball is closer to its target than min_offset_distance, the speed
      *  in addition to the difficulty's default max speed. */
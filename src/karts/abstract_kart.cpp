@@ -81,12 +81,13 @@ void AbstractKart::loadKartProperties(const std::string& new_ident,
                                       std::shared_ptr<RenderInfo> ri)
 {
     m_kart_properties.reset(new KartProperties());
-    const KartProperties* kp = kart_properties_manager->getKart(new_ident);
+    const KartProperties* kp =
+        kart_properties_manager->loadKartModels(new_ident);
     if (kp == NULL)
     {
         Log::warn("Abstract_Kart", "Unknown kart %s, fallback to tux",
             new_ident.c_str());
-        kp = kart_properties_manager->getKart(std::string("tux"));
+        kp = kart_properties_manager->loadKartModels(std::string("tux"));
     }
     m_kart_properties->copyForPlayer(kp, difficulty);
     m_name = m_kart_properties->getName();
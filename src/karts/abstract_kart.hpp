@@ -481,6 +481,10 @@ public:
     // ------------------------------------------------------------------------
     virtual void crashed(const Material *m, const Vec3 &normal) = 0;
     // ------------------------------------------------------------------------
+    /** Returns the number of collisions (calls to crashed) since the last
+     *  reset. */
+    virtual unsigned int getCollisionCount() const = 0;
+    // ------------------------------------------------------------------------
     /** Returns the normal of the terrain the kart is over atm. This is
      *  defined even if the kart is flying. */
     virtual const Vec3& getNormal() const = 0;
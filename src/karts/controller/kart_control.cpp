@@ -18,6 +18,7 @@
 
 #include "karts/controller/kart_control.hpp"
 
+#include "utils/snapshot.hpp"
 
 #include "irrMath.h"
 #include <algorithm>
@@ -79,3 +80,20 @@ void KartControl::setLookBack(bool b)
 {
     m_look_back   = b;
 }   // setLookBack
+
+// ----------------------------------------------------------------------------
+/** Saves the controls, all buttons are compressed into a single byte. */
+void KartControl::saveState(Snapshot *s) const
+{
+    s->add(m_steer);
+    s->add(m_accel);
+    s->add(getButtonsCompressed());
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void KartControl::restoreState(Snapshot *s)
+{
+    s->get(&m_steer);
+    s->get(&m_accel);
+    setButtonsCompressed(s->get<char>());
+}   // restoreState
@@ -21,6 +21,8 @@
 
 #include "utils/types.hpp"
 
+class Snapshot;
+
 /**
   * \ingroup controller
   */
@@ -58,6 +60,8 @@ public:
     void setRescue(bool b);
     void setFire(bool b);
     void setLookBack(bool b);
+    void saveState(Snapshot *s) const;
+    void restoreState(Snapshot *s);
 
     // ------------------------------------------------------------------------
     KartControl()
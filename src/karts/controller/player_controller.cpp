@@ -352,5 +352,5 @@ core::stringw PlayerController::getName() const
 // ----------------------------------------------------------------------------
 void PlayerController::displayPenaltyWarning()
 {
-    m_penalty_ticks = stk_config->m_penalty_ticks;
+    m_penalty_ticks = stk_config->time2Ticks(stk_config->m_penalty_time);
 }   // displayPenaltyWarning
@@ -69,7 +69,9 @@
 #include "utils/constants.hpp"
 #include "utils/helpers.hpp"
 #include "utils/log.hpp" //TODO: remove after debugging is done
+#include "utils/phase_timer.hpp"
 #include "utils/profiler.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/vs.hpp"
 
@@ -120,6 +122,7 @@ Kart::Kart (const std::string& ident, unsigned int world_kart_id,
     m_boosted_ai           = false;
     m_type                 = RaceManager::KT_AI;
     m_flying               = false;
+    m_collision_count      = 0;
 
     m_xyz_history_size     = stk_config->time2Ticks(XYZ_HISTORY_TIME);
 
@@ -291,6 +294,7 @@ void Kart::reset()
     m_energy_to_min_ratio  = 0;
     m_collected_energy     = 0;
     m_bounce_back_ticks    = 0;
+    m_collision_count      = 0;
     m_brake_ticks          = 0;
     m_ticks_last_crash     = 0;
     m_ticks_last_zipper    = 0;
@@ -365,6 +369,125 @@ void Kart::reset()
 
 }   // reset
 
+// -----------------------------------------------------------------------------
+/** Saves the complete simulation state of this kart (rigid body, vehicle,
+ *  timers, powerup, attachment, ...). Kart animations (rescue, explosion,
+ *  cannon) and controller internals are not part of the snapshot.
+ */
+void Kart::saveState(Snapshot *s) const
+{
+    AbstractKart::saveState(s);
+    m_vehicle->saveState(s);
+    m_controls.saveState(s);
+    m_max_speed->saveState(s);
+    m_skidding->saveState(s);
+    m_powerup->saveState(s);
+    m_attachment->saveState(s);
+    m_slipstream->saveState(s);
+
+    s->add(m_xyz_front);
+    for (int i = 0; i < m_xyz_history_size; i++)
+    {
+        s->add(m_previous_xyz[i]);
+        s->add(m_previous_xyz_times[i]);
+    }
+    s->add(m_time_previous_counter);
+    s->add(m_is_jumping);
+    s->add(m_bubblegum_torque_sign);
+    s->add(m_bounce_back_ticks);
+    s->add(m_collision_count);
+    s->add(m_flying);
+    s->add(m_last_used_powerup);
+    s->add(m_has_caught_nolok_bubblegum);
+    s->add(m_race_result);
+    s->add(m_eliminated);
+    s->add(m_race_position);
+    s->add(m_brake_ticks);
+    s->add(m_invulnerable_ticks);
+    s->add(m_bubblegum_ticks);
+    s->add(m_view_blocked_by_plunger);
+    s->add(m_current_lean);
+    s->add(m_min_nitro_ticks);
+    s->add(m_fire_clicked);
+    s->add(m_finished_race);
+    s->add(m_finish_time);
+    s->add(m_collected_energy);
+    s->add(m_energy_to_min_ratio);
+    s->add(m_startup_boost);
+    s->add(m_falling_time);
+    s->add(m_speed);
+    s->add(m_ticks_last_crash);
+    s->add(m_ticks_last_zipper);
+}   // saveState
+
+// -----------------------------------------------------------------------------
+/** Restores the state written by saveState. A running kart animation is
+ *  ended first, the same way reset() does it.
+ */
+void Kart::restoreState(Snapshot *s)
+{
+    if (m_kart_animation)
+    {
+        m_kart_animation->handleResetRace();
+        delete m_kart_animation;
+        m_kart_animation = NULL;
+        Physics::getInstance()->removeKart(this);
+        Physics::getInstance()->addKart(this);
+    }
+
+    // The chassis must be restored before the vehicle, which recomputes
+    // the wheel transforms from it.
+    AbstractKart::restoreState(s);
+    m_vehicle->restoreState(s);
+    m_controls.restoreState(s);
+    m_max_speed->restoreState(s);
+    m_skidding->restoreState(s);
+    m_powerup->restoreState(s);
+    m_attachment->restoreState(s);
+    m_slipstream->restoreState(s);
+    updateWeight();
+
+    m_xyz_front = s->getVec3();
+    for (int i = 0; i < m_xyz_history_size; i++)
+    {
+        m_previous_xyz[i] = s->getVec3();
+        s->get(&m_previous_xyz_times[i]);
+    }
+    s->get(&m_time_previous_counter);
+    s->get(&m_is_jumping);
+    s->get(&m_bubblegum_torque_sign);
+    s->get(&m_bounce_back_ticks);
+    s->get(&m_collision_count);
+    bool flying = s->get<bool>();
+    if (m_flying && !flying)
+        stopFlying();
+    m_flying = flying;
+    s->get(&m_last_used_powerup);
+    s->get(&m_has_caught_nolok_bubblegum);
+    s->get(&m_race_result);
+    s->get(&m_eliminated);
+    s->get(&m_race_position);
+    s->get(&m_brake_ticks);
+    s->get(&m_invulnerable_ticks);
+    s->get(&m_bubblegum_ticks);
+    s->get(&m_view_blocked_by_plunger);
+    s->get(&m_current_lean);
+    s->get(&m_min_nitro_ticks);
+    s->get(&m_fire_clicked);
+    s->get(&m_finished_race);
+    s->get(&m_finish_time);
+    s->get(&m_collected_energy);
+    s->get(&m_energy_to_min_ratio);
+    s->get(&m_startup_boost);
+    s->get(&m_falling_time);
+    s->get(&m_speed);
+    s->get(&m_ticks_last_crash);
+    s->get(&m_ticks_last_zipper);
+
+    m_terrain_info->update(getTrans().getBasis(),
+        getTrans().getOrigin() + getTrans().getBasis() * Vec3(0, 0.3f, 0));
+}   // restoreState
+
 // -----------------------------------------------------------------------------
 void Kart::setXYZ(const Vec3& a)
 {
@@ -1178,7 +1301,10 @@ void Kart::update(int ticks)
     // based on the collision speed.
     m_body->setRestitution(m_kart_properties->getRestitution(fabsf(m_speed)));
 
-    m_controller->update(ticks);
+    {
+        PhaseTimer::Scope timer(PhaseTimer::PHASE_CONTROLLER);
+        m_controller->update(ticks);
+    }
 
 #ifndef SERVER_ONLY
 #undef DEBUG_CAMERA_SHAKE
@@ -1878,6 +2004,7 @@ void Kart::setSlipstreamEffect(float f)
  */
 void Kart::crashed(AbstractKart *k, bool update_attachments)
 {
+    m_collision_count++;
     if(update_attachments)
     {
         assert(k);
@@ -1894,6 +2021,7 @@ void Kart::crashed(AbstractKart *k, bool update_attachments)
  */
 void Kart::crashed(const Material *m, const Vec3 &normal)
 {
+    m_collision_count++;
     const LinearWorld *lw = dynamic_cast<LinearWorld*>(World::getWorld());
     if(m_kart_properties->getTerrainImpulseType()
                              ==KartProperties::IMPULSE_NORMAL &&
@@ -2692,6 +2820,8 @@ btQuaternion Kart::getVisualRotation() const
 void Kart::setOnScreenText(const core::stringw& text)
 {
 #ifndef SERVER_ONLY
+    if (CVS->isNoGraphics())
+        return;
     BoldFace* bold_face = font_manager->getFont<BoldFace>();
     STKTextBillboard* tb =
         new STKTextBillboard(video::SColor(255, 255, 128, 0),
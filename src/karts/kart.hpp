@@ -38,6 +38,7 @@
 class AbstractKartAnimation;
 class Attachment;
 class btKart;
+class btKartRaycaster;
 class btUprightConstraint;
 class Controller;
 class HitEffect;
@@ -51,6 +52,7 @@ class Shadow;
 class Skidding;
 class SkidMarks;
 class SlipStream;
+class Snapshot;
 class Stars;
 class TerrainInfo;
 
@@ -100,6 +102,10 @@ protected:
      *  the karts to bounce back*/
     uint8_t      m_bounce_back_ticks;
 
+    /** Number of collisions with karts, the track or static objects since
+     *  the last reset. A kart scraping along a wall collides every tick. */
+    unsigned int m_collision_count;
+
 protected:
     /** Handles speed increase and capping due to powerup, terrain, ... */
     MaxSpeed *m_max_speed;
@@ -110,7 +116,7 @@ protected:
     /** Handles the powerup of a kart. */
     Powerup *m_powerup;
 
-    std::unique_ptr<btVehicleRaycaster> m_vehicle_raycaster;
+    std::unique_ptr<btKartRaycaster> m_vehicle_raycaster;
 
     std::unique_ptr<btKart> m_vehicle;
 
@@ -282,6 +288,8 @@ public:
     virtual float getTerrainPitch(float heading) const OVERRIDE;
 
     virtual void   reset            () OVERRIDE;
+    virtual void   saveState        (Snapshot *s) const OVERRIDE;
+    virtual void   restoreState     (Snapshot *s) OVERRIDE;
     virtual void   handleZipper     (const Material *m=NULL) OVERRIDE;
     virtual bool   setSquash        (float time, float slowdown) OVERRIDE;
             void   setSquashGraphics();
@@ -322,6 +330,9 @@ public:
     // ----------------------------------------------------------------------------------------
     virtual float  getSpeed() const OVERRIDE { return m_speed; }
     // ----------------------------------------------------------------------------------------
+    virtual unsigned int getCollisionCount() const OVERRIDE
+                                               { return m_collision_count; }
+    // ----------------------------------------------------------------------------------------
     virtual float  getCurrentMaxSpeed() const OVERRIDE;
     // ----------------------------------------------------------------------------------------
     /** This is used on the client side only to set the speed of the kart
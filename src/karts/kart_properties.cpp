@@ -90,6 +90,7 @@ KartProperties::KartProperties(const std::string &filename)
     m_color                      = video::SColor(255, 0, 0, 0);
     m_shape                      = 32;  // close enough to a circle.
     m_nitro_min_consumption      = 64;
+    m_models_loaded              = false;
     // The default constructor for stk_config uses filename=""
     if (filename != "")
     {
@@ -232,6 +233,18 @@ void KartProperties::load(const std::string &filename, const std::string &node)
     if(m_groups.size()==0)
         m_groups.push_back(DEFAULT_GROUP_NAME);
 
+}   // load
+
+//-----------------------------------------------------------------------------
+/** Loads the materials, icons and 3d models of this kart. This is the slow
+ *  part of loading a kart, so KartPropertiesManager can defer it until the
+ *  kart is used in a race. Does nothing if the models are loaded already.
+ *  Throws an exception if the models cannot be loaded.
+ */
+void KartProperties::loadModels()
+{
+    if (m_models_loaded)
+        return;
 
     // Load material
     std::string materials_file = m_root+"materials.xml";
@@ -309,8 +322,8 @@ void KartProperties::load(const std::string &filename, const std::string &node)
     STKTexManager::getInstance()->unsetTextureErrorMessage();
     file_manager->popTextureSearchPath();
     file_manager->popModelSearchPath();
-
-}   // load
+    m_models_loaded = true;
+}   // loadModels
 
 // ----------------------------------------------------------------------------
 /** Returns a pointer to the KartModel object.
@@ -146,6 +146,9 @@ private:
 
     bool m_is_addon;
 
+    /** True once the materials, icons and models of this kart are loaded. */
+    bool m_models_loaded;
+
     /** Type of the kart (for the properties) */
     std::string m_kart_type;
 
@@ -211,6 +214,7 @@ public:
     void  copyForPlayer     (const KartProperties *source,
                              PerPlayerDifficulty d = PLAYER_DIFFICULTY_NORMAL);
     void  copyFrom          (const KartProperties *source);
+    void  loadModels        ();
     void  getAllData        (const XMLNode * root);
     void  checkAllSet       (const std::string &filename);
     bool  isInGroup         (const std::string &group) const;
@@ -267,6 +271,10 @@ public:
     /** Returns the version of the .kart file. */
     int   getVersion                () const {return m_version;               }
 
+    // ------------------------------------------------------------------------
+    /** Returns true if the models of this kart are loaded. */
+    bool  areModelsLoaded           () const {return m_models_loaded;         }
+
     // ------------------------------------------------------------------------
     /** Returns the dot color to use for this kart in the race gui. */
     const video::SColor &getColor   () const {return m_color;                 }
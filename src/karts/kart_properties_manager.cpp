@@ -42,6 +42,7 @@ std::vector<std::string> KartPropertiesManager::m_kart_search_path;
 KartPropertiesManager::KartPropertiesManager()
 {
     m_all_groups.clear();
+    m_load_models_lazily = false;
 }   // KartPropertiesManager
 
 //-----------------------------------------------------------------------------
@@ -234,6 +235,8 @@ bool KartPropertiesManager::loadKart(const std::string &dir)
     try
     {
         kart_properties = new KartProperties(config_filename);
+        if (!m_load_models_lazily)
+            kart_properties->loadModels();
     }
     catch (std::runtime_error& err)
     {
@@ -355,6 +358,36 @@ const KartProperties* KartPropertiesManager::getKart(
     return NULL;
 }   // getKart
 
+//-----------------------------------------------------------------------------
+/** Returns the kart properties of a kart, and loads its models if they were
+ *  not loaded yet. Must be used before a kart is created from the
+ *  properties.
+ *  \param ident Identifier of the kart.
+ *  \return The kart properties, or NULL if the kart is unknown or its models
+ *          cannot be loaded.
+ */
+const KartProperties* KartPropertiesManager::loadKartModels(
+                                                      const std::string &ident)
+{
+    for (KartProperties* kp : m_karts_properties)
+    {
+        if (kp->getIdent() != ident)
+            continue;
+        try
+        {
+            kp->loadModels();
+        }
+        catch (std::runtime_error& err)
+        {
+            Log::error("[KartPropertiesManager]", "Cannot load kart '%s': %s",
+                       ident.c_str(), err.what());
+            return NULL;
+        }
+        return kp;
+    }
+    return NULL;
+}   // loadKartModels
+
 //-----------------------------------------------------------------------------
 const KartProperties* KartPropertiesManager::getKartById(int i) const
 {
@@ -64,6 +64,10 @@ private:
      *  all clients or not. */
     std::vector<bool>        m_kart_available;
 
+    /** If set, only the kart.xml of each kart is loaded by loadKart, and
+     *  the models are loaded when the kart is first used in a race. */
+    bool                     m_load_models_lazily;
+
     std::unique_ptr<AbstractCharacteristic>                         m_base_characteristic;
     std::map<std::string, std::unique_ptr<AbstractCharacteristic> > m_difficulty_characteristics;
     std::map<std::string, std::unique_ptr<AbstractCharacteristic> > m_kart_type_characteristics;
@@ -81,6 +85,7 @@ public:
     static void              addKartSearchDir       (const std::string &s);
     const KartProperties*    getKartById            (int i) const;
     const KartProperties*    getKart(const std::string &ident) const;
+    const KartProperties*    loadKartModels(const std::string &ident);
     const int                getKartId(const std::string &ident) const;
     int                      getKartByGroup(const std::string& group,
                                            int i) const;
@@ -128,6 +133,10 @@ public:
     /** Sets a kartid to be selected (used in networking only). */
     void selectKart(int kartid) { m_selected_karts.push_back(kartid); }
     // ------------------------------------------------------------------------
+    /** Defers loading the models of karts loaded afterwards until the kart
+     *  is used (see loadKartModels). */
+    void setLoadModelsLazily(bool lazy) { m_load_models_lazily = lazy; }
+    // ------------------------------------------------------------------------
     /** Returns all directories from which karts were loaded. */
     const std::vector<std::string>* getAllKartDirs() const
                                     { return &m_all_kart_dirs; }
@@ -22,6 +22,7 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/kart_properties.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot.hpp"
 
 #include "physics/btKart.hpp"
 
@@ -84,6 +85,58 @@ void MaxSpeed::reset()
     }
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves all speed increases and decreases.
+ */
+void MaxSpeed::saveState(Snapshot *s) const
+{
+    s->add(m_current_max_speed);
+    s->add(m_add_engine_force);
+    s->add(m_min_speed);
+    for (unsigned int i = MS_DECREASE_MIN; i < MS_DECREASE_MAX; i++)
+    {
+        const SpeedDecrease &sd = m_speed_decrease[i];
+        s->add(sd.m_max_speed_fraction);
+        s->add(sd.m_current_fraction);
+        s->add(sd.m_fade_in_ticks);
+        s->add(sd.m_duration);
+    }
+    for (unsigned int i = MS_INCREASE_MIN; i < MS_INCREASE_MAX; i++)
+    {
+        const SpeedIncrease &si = m_speed_increase[i];
+        s->add(si.m_max_add_speed);
+        s->add(si.m_duration);
+        s->add(si.m_fade_out_time);
+        s->add(si.m_current_speedup);
+        s->add(si.m_engine_force);
+    }
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void MaxSpeed::restoreState(Snapshot *s)
+{
+    s->get(&m_current_max_speed);
+    s->get(&m_add_engine_force);
+    s->get(&m_min_speed);
+    for (unsigned int i = MS_DECREASE_MIN; i < MS_DECREASE_MAX; i++)
+    {
+        SpeedDecrease &sd = m_speed_decrease[i];
+        s->get(&sd.m_max_speed_fraction);
+        s->get(&sd.m_current_fraction);
+        s->get(&sd.m_fade_in_ticks);
+        s->get(&sd.m_duration);
+    }
+    for (unsigned int i = MS_INCREASE_MIN; i < MS_INCREASE_MAX; i++)
+    {
+        SpeedIncrease &si = m_speed_increase[i];
+        s->get(&si.m_max_add_speed);
+        s->get(&si.m_duration);
+        s->get(&si.m_fade_out_time);
+        s->get(&si.m_current_speedup);
+        s->get(&si.m_engine_force);
+    }
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Sets an increased maximum speed for a category.
  *  \param category The category for which to set the higher maximum speed.
@@ -26,6 +26,7 @@
 #include "graphics/material_manager.hpp"
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 
 #include "ISceneNode.h"
 
@@ -197,3 +198,37 @@ void Moveable::setTrans(const btTransform &t)
     if(m_motion_state)
         m_motion_state->setWorldTransform(t);
 }   // setTrans
+
+//-----------------------------------------------------------------------------
+/** Saves the transform, velocities and sleep state of the rigid body.
+ */
+void Moveable::saveState(Snapshot *s) const
+{
+    s->add(m_transform);
+    s->add(m_body->getCenterOfMassTransform());
+    s->add(m_body->getLinearVelocity());
+    s->add(m_body->getAngularVelocity());
+    s->add(m_body->getActivationState());
+    s->add(m_body->getDeactivationTime());
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the rigid body from a snapshot. Accumulated forces are cleared
+ *  since they are applied and reset within each physics step anyway.
+ */
+void Moveable::restoreState(Snapshot *s)
+{
+    btTransform t = s->getTransform();
+    btTransform body = s->getTransform();
+    btVector3 linear = s->getVec3();
+    btVector3 angular = s->getVec3();
+    m_body->setCenterOfMassTransform(body);
+    m_body->setLinearVelocity(linear);
+    m_body->setAngularVelocity(angular);
+    m_body->clearForces();
+    m_body->forceActivationState(s->get<int>());
+    m_body->setDeactivationTime(s->get<btScalar>());
+    setTrans(t);
+    m_velocityLC = getVelocity()*m_transform.getBasis();
+    updatePosition();
+}   // restoreState
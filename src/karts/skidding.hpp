@@ -26,6 +26,7 @@
 
 class Kart;
 class ShowCurve;
+class Snapshot;
 
 #include <vector>
 
@@ -106,6 +107,8 @@ public:
          Skidding(Kart *kart);
         ~Skidding();
     void reset();
+    void saveState(Snapshot *s) const;
+    void restoreState(Snapshot *s);
     float updateGraphics(float dt);
     void update(int dt, bool is_on_ground, float steer,
                 KartControl::SkidControl skidding);
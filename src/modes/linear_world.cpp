@@ -31,6 +31,7 @@
 #include "tracks/track_sector.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 
 #include <climits>
@@ -136,6 +137,42 @@ void LinearWorld::reset(bool restart)
 
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Adds the lap counting state of all karts.
+ */
+void LinearWorld::saveState(Snapshot *s) const
+{
+    WorldWithRank::saveState(s);
+    s->add(m_fastest_lap_ticks);
+    s->add(m_finish_timeout);
+    for (const KartInfo &info : m_kart_info)
+    {
+        s->add(info.m_finished_laps);
+        s->add(info.m_ticks_at_last_lap);
+        s->add(info.m_lap_start_ticks);
+        s->add(info.m_estimated_finish);
+        s->add(info.m_overall_distance);
+        s->add(info.m_wrong_way_timer);
+    }
+}   // saveState
+
+//-----------------------------------------------------------------------------
+void LinearWorld::restoreState(Snapshot *s)
+{
+    WorldWithRank::restoreState(s);
+    s->get(&m_fastest_lap_ticks);
+    s->get(&m_finish_timeout);
+    for (KartInfo &info : m_kart_info)
+    {
+        s->get(&info.m_finished_laps);
+        s->get(&info.m_ticks_at_last_lap);
+        s->get(&info.m_lap_start_ticks);
+        s->get(&info.m_estimated_finish);
+        s->get(&info.m_overall_distance);
+        s->get(&info.m_wrong_way_timer);
+    }
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** General update function called once per frame. This updates the kart
  *  sectors, which are then used to determine the kart positions.
@@ -28,6 +28,7 @@
 #include "graphics/render_info.hpp"
 #include "io/file_manager.hpp"
 #include "input/input.hpp"
+#include "items/item_manager.hpp"
 #include "items/projectile_manager.hpp"
 #include "karts/controller/battle_ai.hpp"
 #include "karts/controller/end_controller.hpp"
@@ -41,6 +42,7 @@
 #include "physics/btKart.hpp"
 #include "physics/physics.hpp"
 #include "physics/triangle_mesh.hpp"
+#include "race/race_context.hpp"
 #include "race/race_manager.hpp"
 #include "scriptengine/script_engine.hpp"
 #include "tracks/check_manager.hpp"
@@ -49,7 +51,9 @@
 #include "tracks/track_object.hpp"
 #include "tracks/track_object_manager.hpp"
 #include "utils/constants.hpp"
+#include "utils/phase_timer.hpp"
 #include "utils/profiler.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 
 #include <algorithm>
@@ -133,7 +137,9 @@ void World::init()
     // mode class, which would not have been constructed at the time that this
     // constructor is called, so the wrong race gui would be created.
     // Grab the track file
-    Track *track = track_manager->getTrack(race_manager->getTrackName());
+    // If another race in this process has this track loaded, the race
+    // context hands out a private copy.
+    Track *track = RaceContext::getTrack(race_manager->getTrackName());
     Scripting::ScriptEngine::getInstance<Scripting::ScriptEngine>();
     if(!track)
     {
@@ -264,6 +270,56 @@ void World::reset(bool restart)
     m_unfair_team = false;
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves everything needed to continue the race exactly from this point:
+ *  time, karts, items, check structures, physical track objects and
+ *  projectiles. Modes derived from World add their own state.
+ */
+void World::saveState(Snapshot *s) const
+{
+    s->addString(Track::getCurrentTrack()->getIdent());
+    s->add((uint32_t)m_karts.size());
+    WorldStatus::saveState(s);
+    s->add(Physics::getInstance()->getPhysicsWorld()->getLocalTime());
+    s->add(m_eliminated_karts);
+    s->add(m_eliminated_players);
+    s->add(race_manager->getFinishedKarts());
+    s->add(race_manager->getFinishedPlayers());
+    for (auto &kart : m_karts)
+        kart->saveState(s);
+    ItemManager::get()->saveState(s);
+    if (CheckManager::get())
+        CheckManager::get()->saveState(s);
+    Track::getCurrentTrack()->getTrackObjectManager()->saveState(s);
+    projectile_manager->saveState(s);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores a snapshot taken with saveState. The snapshot must come from a
+ *  race on the same track with the same karts.
+ */
+void World::restoreState(Snapshot *s)
+{
+    if (s->getString() != Track::getCurrentTrack()->getIdent() ||
+        s->get<uint32_t>() != m_karts.size())
+        throw std::runtime_error("Snapshot was taken on a different track "
+                                 "or with a different number of karts");
+    WorldStatus::restoreState(s);
+    Physics::getInstance()->getPhysicsWorld()
+        ->setLocalTime(s->get<float>());
+    s->get(&m_eliminated_karts);
+    s->get(&m_eliminated_players);
+    unsigned int finished_karts = s->get<unsigned int>();
+    race_manager->setFinishedKarts(finished_karts, s->get<unsigned int>());
+    for (auto &kart : m_karts)
+        kart->restoreState(s);
+    ItemManager::get()->restoreState(s);
+    if (CheckManager::get())
+        CheckManager::get()->restoreState(s);
+    Track::getCurrentTrack()->getTrackObjectManager()->restoreState(s);
+    projectile_manager->restoreState(s);
+}   // restoreState
+
 
 //-----------------------------------------------------------------------------
 /** Creates a kart, having a certain position, starting location, and local
@@ -367,9 +423,15 @@ Controller* World::loadAIController(AbstractKart* kart)
 //-----------------------------------------------------------------------------
 World::~World()
 {
-    material_manager->unloadAllTextures();
+    // The textures and the scene are shared with all other races of this
+    // process, only the last race unloads them.
+    const bool last_race = RaceContext::getNumRaces() <= 1;
+    if (last_race)
+    {
+        material_manager->unloadAllTextures();
 
-    irr_driver->onUnloadWorld();
+        irr_driver->onUnloadWorld();
+    }
 
     projectile_manager->cleanup();
 
@@ -393,7 +455,8 @@ World::~World()
 
     m_world = NULL;
 
-    irr_driver->getSceneManager()->clear();
+    if (last_race)
+        irr_driver->getSceneManager()->clear();
 
 #ifdef DEBUG
     m_magic_number = 0xDEADBEEF;
@@ -646,10 +709,14 @@ void World::updateGraphics(float dt)
 
 void World::updateGraphicsMinimal(float dt)
 {
-    PROFILER_PUSH_CPU_MARKER("World::updateGraphics (camera)", 0x60, 0x7F, 0);
-    for (unsigned int i = 0; i < Camera::getNumCameras(); i++)
-        Camera::getCamera(i)->update(dt);
-    PROFILER_POP_CPU_MARKER();
+    // Without graphics nothing looks through the cameras
+    if (!CVS->isNoGraphics())
+    {
+        PROFILER_PUSH_CPU_MARKER("World::updateGraphics (camera)", 0x60, 0x7F, 0);
+        for (unsigned int i = 0; i < Camera::getNumCameras(); i++)
+            Camera::getCamera(i)->update(dt);
+        PROFILER_POP_CPU_MARKER();
+    }
 
     Scripting::ScriptEngine *script_engine =
         Scripting::ScriptEngine::getInstance();
@@ -700,7 +767,10 @@ void World::update(int ticks)
     PROFILER_POP_CPU_MARKER();
 
     PROFILER_PUSH_CPU_MARKER("World::update (physics)", 0xa0, 0x7F, 0x00);
-    Physics::getInstance()->update(ticks);
+    {
+        PhaseTimer::Scope timer(PhaseTimer::PHASE_PHYSICS);
+        Physics::getInstance()->update(ticks);
+    }
     PROFILER_POP_CPU_MARKER();
 
     PROFILER_POP_CPU_MARKER();
@@ -218,6 +218,8 @@ public:
     virtual void    updateGraphics(float dt);
     virtual void    terminateRace() OVERRIDE;
     virtual void    reset(bool restart=false) OVERRIDE;
+    virtual void    saveState(Snapshot *s) const;
+    virtual void    restoreState(Snapshot *s);
     virtual void    getDefaultCollectibles(int *collectible_type,
                                            int *amount );
     // ------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include "karts/abstract_kart.hpp"
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 
 #include <irrlicht.h>
 
@@ -216,3 +217,24 @@ void WorldStatus::setTicks(int ticks)
     m_time_ticks = ticks;
     m_time = stk_config->ticks2Time(ticks);
 }   // setTicks
+
+//-----------------------------------------------------------------------------
+/** Saves the clock and race phase. */
+void WorldStatus::saveState(Snapshot *s) const
+{
+    s->add(m_time);
+    s->add(m_time_ticks);
+    s->add(m_clock_mode);
+    s->add((Phase)m_phase);
+    s->add(m_count_up_ticks);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+void WorldStatus::restoreState(Snapshot *s)
+{
+    s->get(&m_time);
+    s->get(&m_time_ticks);
+    s->get(&m_clock_mode);
+    m_phase = s->get<Phase>();
+    s->get(&m_count_up_ticks);
+}   // restoreState
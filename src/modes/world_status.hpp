@@ -21,6 +21,8 @@
 #include "utils/cpp2011.hpp"
 #include <atomic>
 
+class Snapshot;
+
 /**
  * \brief A class that manages the clock (countdown, chrono, etc.)
  * Also manages stuff like the 'ready/set/go' text at the beginning or the delay at the end of a race.
@@ -90,6 +92,8 @@ public:
     virtual void terminateRace();
     void         setTime(const float time);
     void         setTicks(int ticks);
+    void         saveState(Snapshot *s) const;
+    void         restoreState(Snapshot *s);
     // ------------------------------------------------------------------------
     bool     isRacePhase()  const  { return m_phase>=RACE_PHASE &&
                                             m_phase<FINISH_PHASE;           }
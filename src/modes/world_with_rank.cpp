@@ -25,6 +25,7 @@
 #include "tracks/track.hpp"
 #include "tracks/track_sector.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot.hpp"
 
 #include <iostream>
 
@@ -73,6 +74,28 @@ void WorldWithRank::reset(bool restart)
     }
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Adds the race positions and track sectors of all karts.
+ */
+void WorldWithRank::saveState(Snapshot *s) const
+{
+    World::saveState(s);
+    for (unsigned int i = 0; i < m_position_index.size(); i++)
+        s->add(m_position_index[i]);
+    for (unsigned int i = 0; i < m_kart_track_sector.size(); i++)
+        m_kart_track_sector[i]->saveState(s);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+void WorldWithRank::restoreState(Snapshot *s)
+{
+    World::restoreState(s);
+    for (unsigned int i = 0; i < m_position_index.size(); i++)
+        s->get(&m_position_index[i]);
+    for (unsigned int i = 0; i < m_kart_track_sector.size(); i++)
+        m_kart_track_sector[i]->restoreState(s);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Returns the kart with a given position.
  *  \param p The position of the kart, 1<=p<=num_karts).
@@ -29,6 +29,7 @@
 #include "physics/triangle_mesh.hpp"
 #include "tracks/terrain_info.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 
 #define ROLLING_INFLUENCE_FIX
 
@@ -42,7 +43,7 @@ btRigidBody& btKart::getFixedBody()
 }
 
 // ============================================================================
-btKart::btKart(btRigidBody* chassis, btVehicleRaycaster* raycaster,
+btKart::btKart(btRigidBody* chassis, btKartRaycaster* raycaster,
                Kart *kart)
       : m_vehicleRaycaster(raycaster)
 {
@@ -131,6 +132,61 @@ void btKart::reset()
 
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the timed impulses and rotations, speed limits and the state of all
+ *  wheels. The chassis body is saved by the kart.
+ */
+void btKart::saveState(Snapshot *s) const
+{
+    s->add(m_allow_sliding);
+    s->add(m_additional_impulse);
+    s->add(m_ticks_additional_impulse);
+    s->add(m_additional_rotation);
+    s->add(m_ticks_additional_rotation);
+    s->add(m_min_speed);
+    s->add(m_max_speed);
+    for (int i = 0; i < getNumWheels(); i++)
+    {
+        const btWheelInfo &wheel = m_wheelInfo[i];
+        s->add(wheel.m_raycastInfo.m_suspensionLength);
+        s->add(wheel.m_suspensionRelativeVelocity);
+        s->add(wheel.m_wheelsSuspensionForce);
+        s->add(wheel.m_steering);
+        s->add(wheel.m_skidInfo);
+        s->add(wheel.m_was_on_ground);
+        s->add(wheel.m_engineForce);
+        s->add(wheel.m_brake);
+    }
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved by saveState. The chassis body must be restored
+ *  already, since the wheel raycasts are redone from its transform.
+ */
+void btKart::restoreState(Snapshot *s)
+{
+    s->get(&m_allow_sliding);
+    m_additional_impulse = s->getVec3();
+    s->get(&m_ticks_additional_impulse);
+    s->get(&m_additional_rotation);
+    s->get(&m_ticks_additional_rotation);
+    s->get(&m_min_speed);
+    s->get(&m_max_speed);
+    updateAllWheelTransformsWS();
+    for (int i = 0; i < getNumWheels(); i++)
+    {
+        btWheelInfo &wheel = m_wheelInfo[i];
+        s->get(&wheel.m_raycastInfo.m_suspensionLength);
+        s->get(&wheel.m_suspensionRelativeVelocity);
+        s->get(&wheel.m_wheelsSuspensionForce);
+        s->get(&wheel.m_steering);
+        s->get(&wheel.m_skidInfo);
+        s->get(&wheel.m_was_on_ground);
+        s->get(&wheel.m_engineForce);
+        s->get(&wheel.m_brake);
+    }
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 const btTransform& btKart::getWheelTransformWS( int wheelIndex ) const
 {
@@ -230,21 +286,31 @@ void btKart::updateAllWheelTransformsWS()
 
     m_num_wheels_on_ground       = 0;
     m_visual_wheels_touch_ground = true;
+
+    // The rays of all wheels are cast as one packet
+    btAlignedObjectArray<int> wheels;
+    for (int i=0;i<m_wheelInfo.size();i++)
+        wheels.push_back(i);
+    if (wheels.size() > 0)
+        rayCastWheels(&wheels[0], wheels.size());
+
+    // If the original raycast did not hit the ground,
+    // try a little bit (5%) closer to the centre of the chassis.
+    // Some tracks have very minor gaps that would otherwise
+    // trigger odd physical behaviour.
+    wheels.resize(0);
+    for (int i=0;i<m_wheelInfo.size();i++)
+    {
+        if (!m_wheelInfo[i].m_raycastInfo.m_isInContact)
+            wheels.push_back(i);
+    }
+    if (wheels.size() > 0)
+        rayCastWheels(&wheels[0], wheels.size(), 0.95f);
+
     for (int i=0;i<m_wheelInfo.size();i++)
     {
-        rayCast( i);
-        if(m_wheelInfo[i].m_raycastInfo.m_isInContact)
+        if (m_wheelInfo[i].m_raycastInfo.m_isInContact)
             m_num_wheels_on_ground++;
-        else
-        {
-            // If the original raycast did not hit the ground,
-            // try a little bit (5%) closer to the centre of the chassis.
-            // Some tracks have very minor gaps that would otherwise
-            // trigger odd physical behaviour.
-            rayCast(i, 0.95f);
-            if (m_wheelInfo[i].m_raycastInfo.m_isInContact)
-                m_num_wheels_on_ground++;
-        }
     }
 }   // updateAllWheelTransformsWS
 
@@ -288,6 +354,92 @@ btScalar btKart::rayCast(unsigned int index, float fraction)
 
     void* object = m_vehicleRaycaster->castRay(source,target,rayResults);
 
+    btScalar depth = updateWheelContact(wheel, raylen, object, rayResults);
+
+    if(m_chassisBody->getBroadphaseHandle())
+    {
+        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup
+            = old_group;
+    }
+
+    return depth;
+
+}   // rayCast
+
+// ----------------------------------------------------------------------------
+/** Casts the rays of several wheels as one packet, which is faster than a
+ *  rayCast call for each wheel (see btKartRaycaster::castRays).
+ *  \param wheels Indices of the wheels.
+ *  \param num_wheels Number of wheels.
+ *  \param fraction Fraction of the connection points of the wheels at which
+ *         the rays start, see rayCast.
+ */
+void btKart::rayCastWheels(const int *wheels, int num_wheels, float fraction)
+{
+    // See rayCast: the rays must not hit the chassis
+    short int old_group=0;
+    if(m_chassisBody->getBroadphaseHandle())
+    {
+        old_group = m_chassisBody->getBroadphaseHandle()
+                                 ->m_collisionFilterGroup;
+        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup = 0;
+    }
+
+    btAlignedObjectArray<btVector3> from, to;
+    btAlignedObjectArray<btScalar> raylen;
+    btAlignedObjectArray<btVehicleRaycaster::btVehicleRaycasterResult> results;
+    btAlignedObjectArray<void*> objects;
+    from.resize(num_wheels);
+    to.resize(num_wheels);
+    raylen.resize(num_wheels);
+    results.resize(num_wheels);
+    objects.resize(num_wheels);
+
+    const btTransform &chassis_trans = getChassisWorldTransform();
+    for (int i = 0; i < num_wheels; i++)
+    {
+        btWheelInfo &wheel = m_wheelInfo[wheels[i]];
+        updateWheelTransformsWS(wheel, chassis_trans, false, fraction);
+        raylen[i] = wheel.getSuspensionRestLength()
+                  + wheel.m_maxSuspensionTravel + 0.5f;
+        from[i] = wheel.m_raycastInfo.m_hardPointWS;
+        to[i]   = from[i] + wheel.m_raycastInfo.m_wheelDirectionWS*raylen[i];
+        wheel.m_raycastInfo.m_contactPointWS = to[i];
+    }
+
+    btAssert(m_vehicleRaycaster);
+    m_vehicleRaycaster->castRays(num_wheels, &from[0], &to[0], &results[0],
+                                 &objects[0]);
+
+    for (int i = 0; i < num_wheels; i++)
+    {
+        updateWheelContact(m_wheelInfo[wheels[i]], raylen[i], objects[i],
+                           results[i]);
+    }
+
+    if(m_chassisBody->getBroadphaseHandle())
+    {
+        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup
+            = old_group;
+    }
+}   // rayCastWheels
+
+// ----------------------------------------------------------------------------
+/** Updates the contact information and suspension of a wheel from the
+ *  result of its raycast.
+ *  \param wheel The wheel.
+ *  \param raylen Length of the ray that was cast.
+ *  \param object The object that was hit, or NULL.
+ *  \param rayResults The result of the raycast.
+ *  \return The distance to the ground, or -1 if the wheel is not in contact.
+ */
+btScalar btKart::updateWheelContact(btWheelInfo &wheel, btScalar raylen,
+                const void *object,
+                const btVehicleRaycaster::btVehicleRaycasterResult &rayResults)
+{
+    btScalar max_susp_len = wheel.getSuspensionRestLength()
+                          + wheel.m_maxSuspensionTravel;
+
     wheel.m_raycastInfo.m_groundObject = 0;
 
     btScalar depth =  raylen * rayResults.m_distFraction;
@@ -354,15 +506,8 @@ btScalar btKart::rayCast(unsigned int index, float fraction)
         wheel.m_clippedInvContactDotSuspension = btScalar(1.0);
     }
 
-    if(m_chassisBody->getBroadphaseHandle())
-    {
-        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup
-            = old_group;
-    }
-
     return depth;
-
-}   // rayCast
+}   // updateWheelContact
 
 // ----------------------------------------------------------------------------
 /** Returns the contact point of a visual wheel.
@@ -23,6 +23,7 @@ class btDynamicsWorld;
 
 class btVehicleTuning;
 class Kart;
+class Snapshot;
 struct btWheelContactPoint;
 
 /** rayCast vehicle, very special constraint that turn a rigidbody into a
@@ -69,7 +70,7 @@ private:
     btScalar calcRollingFriction(btWheelContactPoint& contactPoint);
 
     btScalar            m_damping;
-    btVehicleRaycaster *m_vehicleRaycaster;
+    btKartRaycaster    *m_vehicleRaycaster;
 
     /** Sliding (skidding) will only be permited when this is true. Also check
      *  the friction parameter in the wheels since friction directly affects
@@ -123,6 +124,11 @@ private:
 
     void     defaultInit();
     btScalar rayCast(btWheelInfo& wheel, const btVector3& ray);
+    void     rayCastWheels(const int *wheels, int num_wheels,
+                           float fraction=1.0f);
+    btScalar updateWheelContact(btWheelInfo &wheel, btScalar raylen,
+                const void *object,
+                const btVehicleRaycaster::btVehicleRaycasterResult &rayResults);
     void     updateWheelTransformsWS(btWheelInfo& wheel,
                                      btTransform chassis_trans,
                                      bool interpolatedTransform=true,
@@ -137,10 +143,12 @@ public:
      *         (this is used to get access to the kart properties).
      */
                        btKart(btRigidBody* chassis,
-                              btVehicleRaycaster* raycaster,
+                              btKartRaycaster* raycaster,
                               Kart *kart);
      virtual          ~btKart();
     void               reset();
+    void               saveState(Snapshot *s) const;
+    void               restoreState(Snapshot *s);
     void               debugDraw(btIDebugDraw* debugDrawer);
     const btTransform& getChassisWorldTransform() const;
     btScalar           rayCast(unsigned int index, float fraction=1.0f);
@@ -12,15 +12,17 @@
 #include "LinearMath/btVector3.h"
 #include "btKartRaycast.hpp"
 
+#include "BulletCollision/BroadphaseCollision/btBroadphaseInterface.h"
 #include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 
 #include "modes/world.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
 
-void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
-                               btVehicleRaycasterResult& result)
+namespace
 {
     // ========================================================================
     class ClosestWithNormal : public btCollisionWorld::ClosestRayResultCallback
@@ -55,21 +57,214 @@ void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
         int getTriangleIndex() const { return m_triangle_index; }
 
     };   // CloestWithNormal
+
+    // ========================================================================
+    /** Collects all collision objects whose bounding box overlaps the
+     *  bounding box of a ray packet. */
+    class PacketObjects : public btBroadphaseAabbCallback
+    {
+    public:
+        btAlignedObjectArray<btCollisionObject*> m_objects;
+        // --------------------------------------------------------------------
+        virtual bool process(const btBroadphaseProxy *proxy)
+        {
+            m_objects.push_back((btCollisionObject*)proxy->m_clientObject);
+            return true;
+        }   // process
+    };   // PacketObjects
+
+    // ========================================================================
+    /** Collects the triangles of a triangle mesh (in mesh space) that
+     *  overlap the bounding box of a ray packet. */
+    class PacketTriangles : public btTriangleCallback
+    {
+    public:
+        /** Three vertices per triangle. */
+        btAlignedObjectArray<btVector3> m_vertices;
+        btAlignedObjectArray<int>       m_parts;
+        btAlignedObjectArray<int>       m_indices;
+        // --------------------------------------------------------------------
+        virtual void processTriangle(btVector3 *triangle, int part, int index)
+        {
+            m_vertices.push_back(triangle[0]);
+            m_vertices.push_back(triangle[1]);
+            m_vertices.push_back(triangle[2]);
+            m_parts.push_back(part);
+            m_indices.push_back(index);
+        }   // processTriangle
+    };   // PacketTriangles
+
     // ========================================================================
+    /** Tests one ray of a packet against triangles and reports the hits to
+     *  the result callback of the ray, exactly like the callback that
+     *  btCollisionWorld::rayTestSingle uses for triangle meshes. */
+    class PacketRayTriangle : public btTriangleRaycastCallback
+    {
+    private:
+        btCollisionWorld::RayResultCallback *m_result;
+        btCollisionObject                   *m_object;
+        btMatrix3x3                          m_basis;
+    public:
+        PacketRayTriangle(const btVector3 &from, const btVector3 &to,
+                          btCollisionWorld::RayResultCallback *result,
+                          btCollisionObject *object,
+                          const btMatrix3x3 &basis)
+            : btTriangleRaycastCallback(from, to, result->m_flags),
+              m_result(result), m_object(object), m_basis(basis)
+        {
+            m_hitFraction = result->m_closestHitFraction;
+        }   // PacketRayTriangle
+        // --------------------------------------------------------------------
+        virtual btScalar reportHit(const btVector3 &normal, btScalar fraction,
+                                   int part, int index)
+        {
+            btCollisionWorld::LocalShapeInfo info;
+            info.m_shapePart     = part;
+            info.m_triangleIndex = index;
+            btCollisionWorld::LocalRayResult result(m_object, &info,
+                                                    m_basis*normal, fraction);
+            return m_result->addSingleResult(result,
+                                             /*normalInWorldSpace*/true);
+        }   // reportHit
+    };   // PacketRayTriangle
+}   // namespace
 
+// ----------------------------------------------------------------------------
+void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
+                               btVehicleRaycasterResult& result)
+{
     ClosestWithNormal rayCallback(from,to);
 
     m_dynamicsWorld->rayTest(from, to, rayCallback);
 
-    if (rayCallback.hasHit())
+    return getResult(rayCallback, rayCallback.getTriangleIndex(), result);
+}   // castRay
+
+// ----------------------------------------------------------------------------
+/** Casts a packet of rays that are close to each other, e.g. the rays of
+ *  all wheels of a kart, with the same results as a castRay call for each
+ *  ray. Instead of a broadphase ray test for each ray, all objects that
+ *  overlap the bounding box of the packet are found once. The BVH of a
+ *  triangle mesh (i.e. the track) is traversed once for the whole packet,
+ *  and each ray is only tested against the few triangles it returns.
+ *  Hits at the same distance resolve like in castRay: the first hit wins,
+ *  and objects and triangles are visited in the same order as rayTest
+ *  does (broadphase order, then the node order of the stackless BVH walk).
+ *  Only the rays of one kart are cast together, karts are usually too far
+ *  apart to share a packet. The long terrain probes of TerrainInfo are
+ *  still single rays.
+ *  \param num_rays Number of rays.
+ *  \param from, to Start and end points of all rays.
+ *  \param results The results of all rays.
+ *  \param objects The object hit by each ray (or NULL), see castRay.
+ */
+void btKartRaycaster::castRays(int num_rays, const btVector3 *from,
+                               const btVector3 *to,
+                               btVehicleRaycasterResult *results,
+                               void **objects)
+{
+    if (num_rays <= 0)
+        return;
+
+    btAlignedObjectArray<ClosestWithNormal> callbacks;
+    callbacks.reserve(num_rays);
+    btVector3 aabb_min = from[0], aabb_max = from[0];
+    for (int i = 0; i < num_rays; i++)
     {
-        btRigidBody* body = btRigidBody::upcast(rayCallback.m_collisionObject);
+        callbacks.push_back(ClosestWithNormal(from[i], to[i]));
+        aabb_min.setMin(from[i]);
+        aabb_min.setMin(to[i]);
+        aabb_max.setMax(from[i]);
+        aabb_max.setMax(to[i]);
+    }
+
+    PacketObjects packet_objects;
+    m_dynamicsWorld->getBroadphase()->aabbTest(aabb_min, aabb_max,
+                                               packet_objects);
+
+    PacketTriangles triangles;
+    btAlignedObjectArray<btVector3> local_from, local_to;
+    local_from.resize(num_rays);
+    local_to.resize(num_rays);
+    for (int n = 0; n < packet_objects.m_objects.size(); n++)
+    {
+        btCollisionObject *object = packet_objects.m_objects[n];
+        // All rays use the same collision filter
+        if (!callbacks[0].needsCollision(object->getBroadphaseHandle()))
+            continue;
+
+        const btCollisionShape *shape = object->getCollisionShape();
+        const btTransform &trans = object->getWorldTransform();
+        if (shape->getShapeType() != TRIANGLE_MESH_SHAPE_PROXYTYPE)
+        {
+            for (int i = 0; i < num_rays; i++)
+            {
+                if (callbacks[i].m_closestHitFraction == btScalar(0.f))
+                    continue;
+                btTransform trans_from(btMatrix3x3::getIdentity(), from[i]);
+                btTransform trans_to(btMatrix3x3::getIdentity(), to[i]);
+                btCollisionWorld::rayTestSingle(trans_from, trans_to, object,
+                                                shape, trans, callbacks[i]);
+            }
+            continue;
+        }
+
+        const btTransform world_to_object = trans.inverse();
+        btVector3 local_min, local_max;
+        for (int i = 0; i < num_rays; i++)
+        {
+            local_from[i] = world_to_object * from[i];
+            local_to[i]   = world_to_object * to[i];
+            if (i == 0)
+                local_min = local_max = local_from[0];
+            local_min.setMin(local_from[i]);
+            local_min.setMin(local_to[i]);
+            local_max.setMax(local_from[i]);
+            local_max.setMax(local_to[i]);
+        }
+        triangles.m_vertices.resize(0);
+        triangles.m_parts.resize(0);
+        triangles.m_indices.resize(0);
+        ((const btBvhTriangleMeshShape*)shape)
+            ->processAllTriangles(&triangles, local_min, local_max);
+        for (int i = 0; i < num_rays; i++)
+        {
+            PacketRayTriangle ray(local_from[i], local_to[i], &callbacks[i],
+                                  object, trans.getBasis());
+            for (int t = 0; t < triangles.m_indices.size(); t++)
+            {
+                ray.processTriangle(&triangles.m_vertices[3 * t],
+                                    triangles.m_parts[t],
+                                    triangles.m_indices[t]);
+            }
+        }
+    }
+
+    for (int i = 0; i < num_rays; i++)
+    {
+        objects[i] = getResult(callbacks[i], callbacks[i].getTriangleIndex(),
+                               results[i]);
+    }
+}   // castRays
+
+// ----------------------------------------------------------------------------
+/** Fills the result of a ray from its result callback.
+ *  \return The rigid body that was hit, or NULL.
+ */
+void* btKartRaycaster::getResult(
+                    const btCollisionWorld::ClosestRayResultCallback &callback,
+                    int triangle_index, btVehicleRaycasterResult &result)
+{
+    if (callback.hasHit())
+    {
+        const btRigidBody* body =
+            btRigidBody::upcast(callback.m_collisionObject);
         if (body && body->hasContactResponse())
         {
-            result.m_hitPointInWorld = rayCallback.m_hitPointWorld;
-            result.m_hitNormalInWorld = rayCallback.m_hitNormalWorld;
+            result.m_hitPointInWorld = callback.m_hitPointWorld;
+            result.m_hitNormalInWorld = callback.m_hitNormalWorld;
             result.m_hitNormalInWorld.normalize();
-            result.m_distFraction = rayCallback.m_closestHitFraction;
+            result.m_distFraction = callback.m_closestHitFraction;
             result.m_triangle_index = -1;
             // FIXME: this code assumes atm that the object the kart is
             // driving on is the main track (and not e.g. a physical object).
@@ -79,19 +274,19 @@ void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
             // different triangle mesh). TODO: Add a mapping from bullet
             // objects back to triangle meshes, so that it's easy to pick up
             // the right triangle mesh for smoothing
-            TriangleMesh::RigidBodyTriangleMesh *rbtm =
-                dynamic_cast<TriangleMesh::RigidBodyTriangleMesh*>(body);
+            const TriangleMesh::RigidBodyTriangleMesh *rbtm =
+                dynamic_cast<const TriangleMesh::RigidBodyTriangleMesh*>(body);
             if(m_smooth_normals &&
-                rayCallback.getTriangleIndex()>-1 &&
+                triangle_index>-1 &&
                 rbtm != NULL                         )
             {
 #undef DEBUG_NORMALS
 #ifdef DEBUG_NORMALS
                 btVector3 n=result.m_hitNormalInWorld;
 #endif
-                result.m_triangle_index = rayCallback.getTriangleIndex();
+                result.m_triangle_index = triangle_index;
                 result.m_hitNormalInWorld =
-                    rbtm->m_triangle_mesh->getInterpolatedNormal(rayCallback.getTriangleIndex(),
+                    rbtm->m_triangle_mesh->getInterpolatedNormal(triangle_index,
                                              result.m_hitPointInWorld);
 #ifdef DEBUG_NORMALS
                 printf("old %f %f %f new %f %f %f\n",
@@ -101,9 +296,8 @@ void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
                     result.m_hitNormalInWorld.getZ());
 #endif
             }
-            return body;
+            return (void*)body;
         }
     }
     return 0;
-}
-
+}   // getResult
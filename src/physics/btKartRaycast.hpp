@@ -11,6 +11,7 @@
 #ifndef BTKARTRAYCAST_HPP
 #define BTKARTRAYCAST_HPP
 
+#include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
 #include "BulletDynamics/Vehicle/btVehicleRaycaster.h"
@@ -35,6 +36,14 @@ public:
 
     virtual void* castRay(const btVector3& from,const btVector3& to,
                           btVehicleRaycasterResult& result);
+    void          castRays(int num_rays, const btVector3 *from,
+                           const btVector3 *to,
+                           btVehicleRaycasterResult *results,
+                           void **objects);
+
+private:
+    void* getResult(const btCollisionWorld::ClosestRayResultCallback &callback,
+                    int triangle_index, btVehicleRaycasterResult &result);
 
 };
 
@@ -0,0 +1,168 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/island_solver.hpp"
+
+#include <algorithm>
+
+// ----------------------------------------------------------------------------
+/** Creates the solvers and starts the worker threads.
+ *  \param num_threads Number of threads that solve islands, including the
+ *         thread that calls solve().
+ */
+IslandSolver::IslandSolver(int num_threads)
+{
+    m_generation = 0;
+    m_num_busy   = 0;
+    m_quit       = false;
+    m_info       = NULL;
+    m_dispatcher = NULL;
+    m_next_island.store(0);
+    num_threads = std::max(num_threads, 1);
+    for (int i = 0; i < num_threads; i++)
+        m_solvers.push_back(new btSequentialImpulseConstraintSolver());
+    for (int i = 1; i < num_threads; i++)
+        m_threads.emplace_back(&IslandSolver::runWorker, this, i);
+}   // IslandSolver
+
+// ----------------------------------------------------------------------------
+IslandSolver::~IslandSolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_start_cond.notify_all();
+    for (std::thread &t : m_threads)
+        t.join();
+    for (btSequentialImpulseConstraintSolver *solver : m_solvers)
+        delete solver;
+}   // ~IslandSolver
+
+// ----------------------------------------------------------------------------
+/** Adds an island to be solved by the next solve(). The arrays are copied,
+ *  they belong to bullet's island manager.
+ */
+void IslandSolver::addIsland(btCollisionObject **bodies, int num_bodies,
+                             btPersistentManifold **manifolds,
+                             int num_manifolds,
+                             btTypedConstraint **constraints,
+                             int num_constraints)
+{
+    Island island;
+    island.m_first_body       = m_bodies.size();
+    island.m_num_bodies       = num_bodies;
+    island.m_first_manifold   = m_manifolds.size();
+    island.m_num_manifolds    = num_manifolds;
+    island.m_first_constraint = m_constraints.size();
+    island.m_num_constraints  = num_constraints;
+    for (int i = 0; i < num_bodies; i++)
+        m_bodies.push_back(bodies[i]);
+    for (int i = 0; i < num_manifolds; i++)
+        m_manifolds.push_back(manifolds[i]);
+    for (int i = 0; i < num_constraints; i++)
+        m_constraints.push_back(constraints[i]);
+    m_islands.push_back(island);
+}   // addIsland
+
+// ----------------------------------------------------------------------------
+/** Solves all added islands and removes them. The calling thread solves
+ *  islands as well, and returns once all islands are solved.
+ */
+void IslandSolver::solve(const btContactSolverInfo &info,
+                         btDispatcher *dispatcher)
+{
+    m_info       = &info;
+    m_dispatcher = dispatcher;
+    m_next_island.store(0);
+
+    // Waking up the workers only pays off with more than one island
+    if (m_threads.empty() || m_islands.size() < 2)
+    {
+        solveIslands(0);
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_num_busy = (int)m_threads.size();
+            m_generation++;
+        }
+        m_start_cond.notify_all();
+        solveIslands(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done_cond.wait(lock, [this]() { return m_num_busy == 0; });
+    }
+
+    m_bodies.resize(0);
+    m_manifolds.resize(0);
+    m_constraints.resize(0);
+    m_islands.clear();
+}   // solve
+
+// ----------------------------------------------------------------------------
+/** Solves islands with the solver of a thread until all islands are taken.
+ *  \param index Index of the thread (0 is the thread that calls solve).
+ */
+void IslandSolver::solveIslands(int index)
+{
+    btSequentialImpulseConstraintSolver *solver = m_solvers[index];
+    const int num_islands = (int)m_islands.size();
+    for (int i = m_next_island++; i < num_islands; i = m_next_island++)
+    {
+        const Island &island = m_islands[i];
+        // The random seed (only used with SOLVER_RANDMIZE_ORDER) starts
+        // over for each island, independent of the thread.
+        solver->reset();
+        solver->solveGroup(
+            island.m_num_bodies ? &m_bodies[island.m_first_body] : NULL,
+            island.m_num_bodies,
+            island.m_num_manifolds ? &m_manifolds[island.m_first_manifold]
+                                   : NULL,
+            island.m_num_manifolds,
+            island.m_num_constraints
+                ? &m_constraints[island.m_first_constraint] : NULL,
+            island.m_num_constraints, *m_info, NULL, NULL, m_dispatcher);
+    }
+}   // solveIslands
+
+// ----------------------------------------------------------------------------
+/** The loop of a worker thread: waits for solve() and solves islands.
+ *  \param index Index of the thread.
+ */
+void IslandSolver::runWorker(int index)
+{
+    unsigned int generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_start_cond.wait(lock, [this, generation]()
+                              { return m_quit || m_generation != generation; });
+            if (m_quit)
+                return;
+            generation = m_generation;
+        }
+        solveIslands(index);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_num_busy--;
+        }
+        m_done_cond.notify_one();
+    }
+}   // runWorker
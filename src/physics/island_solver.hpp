@@ -0,0 +1,102 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_ISLAND_SOLVER_HPP
+#define HEADER_ISLAND_SOLVER_HPP
+
+#include "btBulletDynamicsCommon.h"
+
+#include "utils/no_copy.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** \brief Solves the constraints of independent simulation islands on a
+ *  pool of threads.
+ *  Bullet solves all islands with one sequential impulse solver. Islands
+ *  share no dynamic bodies (static bodies like the track are only read), so
+ *  they can be solved concurrently. Physics collects the islands of a step
+ *  with addIsland() and solves them all with solve(). Each thread has its
+ *  own solver, and every island is solved with a reset solver, so the result
+ *  of an island does not depend on the thread it was solved on.
+ *  \ingroup physics
+ */
+class IslandSolver : public NoCopy
+{
+private:
+    /** The bodies, manifolds and constraints of one island, as ranges of
+     *  the arrays below. */
+    struct Island
+    {
+        int m_first_body, m_num_bodies;
+        int m_first_manifold, m_num_manifolds;
+        int m_first_constraint, m_num_constraints;
+    };
+
+    btAlignedObjectArray<btCollisionObject*>    m_bodies;
+    btAlignedObjectArray<btPersistentManifold*> m_manifolds;
+    btAlignedObjectArray<btTypedConstraint*>    m_constraints;
+    std::vector<Island>                         m_islands;
+
+    /** One solver per thread, the main thread uses the first one. */
+    std::vector<btSequentialImpulseConstraintSolver*> m_solvers;
+
+    /** The worker threads (one less than the number of solvers). */
+    std::vector<std::thread> m_threads;
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_start_cond;
+    std::condition_variable  m_done_cond;
+
+    /** Incremented for every solve(), wakes up the workers. */
+    unsigned int             m_generation;
+
+    /** Number of workers that have not finished the current solve(). */
+    int                      m_num_busy;
+
+    bool                     m_quit;
+
+    /** Index of the next island that is not taken by a thread. */
+    std::atomic<int>         m_next_island;
+
+    /** Settings of the current solve(). */
+    const btContactSolverInfo *m_info;
+    btDispatcher              *m_dispatcher;
+
+    void runWorker(int index);
+    void solveIslands(int index);
+
+public:
+             IslandSolver(int num_threads);
+            ~IslandSolver();
+    void     addIsland(btCollisionObject **bodies, int num_bodies,
+                       btPersistentManifold **manifolds, int num_manifolds,
+                       btTypedConstraint **constraints, int num_constraints);
+    void     solve(const btContactSolverInfo &info, btDispatcher *dispatcher);
+    // ------------------------------------------------------------------------
+    /** Returns true if islands were added since the last solve(). */
+    bool     hasIslands() const { return !m_islands.empty(); }
+    // ------------------------------------------------------------------------
+    /** Returns the number of threads (including the calling thread). */
+    int      getNumThreads() const { return (int)m_solvers.size(); }
+};   // IslandSolver
+
+#endif
@@ -33,6 +33,7 @@
 #include "tracks/track_object.hpp"
 #include "utils/constants.hpp"
 #include "utils/mini_glm.hpp"
+#include "utils/snapshot.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/mini_glm.hpp"
 
@@ -682,6 +683,35 @@ void PhysicalObject::reset()
     m_last_lv = m_last_av = Vec3(0.0f);
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the rigid body of a dynamic object (static objects never move).
+ */
+void PhysicalObject::saveState(Snapshot *s) const
+{
+    if (!m_is_dynamic) return;
+    s->add(m_body->getCenterOfMassTransform());
+    s->add(m_body->getLinearVelocity());
+    s->add(m_body->getAngularVelocity());
+    s->add(m_body->getActivationState());
+    s->add(m_body->getDeactivationTime());
+    s->add(m_current_transform);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void PhysicalObject::restoreState(Snapshot *s)
+{
+    if (!m_is_dynamic) return;
+    m_body->setCenterOfMassTransform(s->getTransform());
+    m_body->setLinearVelocity(s->getVec3());
+    m_body->setAngularVelocity(s->getVec3());
+    m_body->clearForces();
+    m_body->forceActivationState(s->get<int>());
+    m_body->setDeactivationTime(s->get<btScalar>());
+    m_current_transform = s->getTransform();
+    if (m_motion_state)
+        m_motion_state->setWorldTransform(m_body->getCenterOfMassTransform());
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 void PhysicalObject::handleExplosion(const Vec3& pos, bool direct_hit)
 {
@@ -31,6 +31,7 @@
 
 
 class Material;
+class Snapshot;
 class TrackObject;
 class XMLNode;
 
@@ -205,6 +206,8 @@ public:
 
     virtual     ~PhysicalObject ();
     virtual void reset          ();
+    void         saveState      (Snapshot *s) const;
+    void         restoreState   (Snapshot *s);
     virtual void handleExplosion(const Vec3& pos, bool directHit);
     void         update         (float dt);
     void         updateGraphics (float dt);
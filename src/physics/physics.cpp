@@ -31,6 +31,7 @@
 #include "karts/explosion_animation.hpp"
 #include "physics/btKart.hpp"
 #include "physics/irr_debug_drawer.hpp"
+#include "physics/island_solver.hpp"
 #include "physics/physical_object.hpp"
 #include "physics/stk_dynamics_world.hpp"
 #include "physics/triangle_mesh.hpp"
@@ -48,6 +49,9 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
 {
     m_collision_conf      = new btDefaultCollisionConfiguration();
     m_dispatcher          = new btCollisionDispatcher(m_collision_conf);
+    m_broadphase          = NULL;
+    m_island_solver       = NULL;
+    m_groups_solved       = false;
 }   // Physics
 
 //-----------------------------------------------------------------------------
@@ -58,9 +62,14 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
 void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
 {
     m_physics_loop_active = false;
-    m_axis_sweep          = new btAxisSweep3(world_min, world_max);
+    // The dynamic AABB tree does not depend on the track bounds, and scales
+    // better with many moving karts and projectiles.
+    if(race_manager->getPhysicsBroadphase() == RaceManager::PB_DBVT)
+        m_broadphase      = new btDbvtBroadphase();
+    else
+        m_broadphase      = new btAxisSweep3(world_min, world_max);
     m_dynamics_world      = new STKDynamicsWorld(m_dispatcher,
-                                                 m_axis_sweep,
+                                                 m_broadphase,
                                                  this,
                                                  m_collision_conf);
     m_karts_to_delete.clear();
@@ -71,9 +80,12 @@ void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
     m_debug_drawer = new IrrDebugDrawer();
     m_dynamics_world->setDebugDrawer(m_debug_drawer);
 
-    // Get the solver settings from the config file
+    // Get the solver settings from the config file (the race can use a
+    // different number of iterations)
     btContactSolverInfo& info = m_dynamics_world->getSolverInfo();
-    info.m_numIterations = stk_config->m_solver_iterations;
+    info.m_numIterations = race_manager->getPhysicsSolverIterations() > 0
+                         ? race_manager->getPhysicsSolverIterations()
+                         : stk_config->m_solver_iterations;
     info.m_splitImpulse  = stk_config->m_solver_split_impulse;
     info.m_splitImpulsePenetrationThreshold =
         stk_config->m_solver_split_impulse_thresh;
@@ -81,6 +93,17 @@ void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
     // Modify the mode according to the bits of the solver mode:
     info.m_solverMode = (info.m_solverMode & (~stk_config->m_solver_reset_flags))
                       | stk_config->m_solver_set_flags;
+
+    // Solve independent islands on several threads. Bullet merges small
+    // islands into batches, which would hide them from the island solver.
+    // Every island is solved separately then, so the results do not depend
+    // on the number of threads, but differ slightly from the batches of the
+    // sequential solver used with one thread.
+    if(race_manager->getPhysicsThreads() > 1)
+    {
+        m_island_solver = new IslandSolver(race_manager->getPhysicsThreads());
+        info.m_minimumSolverBatchSize = 1;
+    }
 }   // init
 
 //-----------------------------------------------------------------------------
@@ -88,7 +111,8 @@ Physics::~Physics()
 {
     delete m_debug_drawer;
     delete m_dynamics_world;
-    delete m_axis_sweep;
+    delete m_broadphase;
+    delete m_island_solver;
     delete m_dispatcher;
     delete m_collision_conf;
 }   // ~Physics
@@ -157,12 +181,18 @@ void Physics::update(int ticks)
     // are stored in a vector, but only one entry per collision pair
     // of objects.
     m_all_collisions.clear();
+    m_track_collisions.clear();
 
     // Since the world update (which calls physics update) is called at the
     // fixed frequency necessary for the physics update, we need to do exactly
-    // one physic step only.
-    m_dynamics_world->stepSimulation(stk_config->ticks2Time(1), 1,
-                                     stk_config->ticks2Time(1)      );
+    // one physic step only. The race can split it into several substeps.
+    const int substeps = race_manager->getPhysicsSubsteps();
+    if(substeps > 1)
+        m_dynamics_world->stepSubsteps(stk_config->ticks2Time(1), substeps);
+    else
+        m_dynamics_world->stepSimulation(stk_config->ticks2Time(1), 1,
+                                         stk_config->ticks2Time(1)      );
+    updateCollisionEvents();
 
     // Now handle the actual collision. Note: flyables can not be removed
     // inside of this loop, since the same flyables might hit more than one
@@ -514,6 +544,16 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                              btStackAlloc* stackAlloc,
                              btDispatcher* dispatcher)
 {
+    // With an island solver each island is only queued here, and all
+    // islands are solved in allSolved. In both cases the collisions are
+    // handled once in allSolved.
+    m_groups_solved = true;
+    if(m_island_solver)
+    {
+        m_island_solver->addIsland(bodies, numBodies, manifold, numManifolds,
+                                   constraints, numConstraints);
+        return 0;
+    }
     btScalar returnValue=
         btSequentialImpulseConstraintSolver::solveGroup(bodies, numBodies,
                                                         manifold, numManifolds,
@@ -522,6 +562,33 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                                                         debugDrawer,
                                                         stackAlloc,
                                                         dispatcher);
+    return returnValue;
+}   // solveGroup
+
+// ----------------------------------------------------------------------------
+/** Called by bullet once all islands are passed to solveGroup. If an island
+ *  solver is used, this solves all queued islands in parallel. Then the
+ *  collisions are handled, once per physics step with and without island
+ *  solver (handleManifolds looks at all manifolds, not only the ones of a
+ *  group).
+ */
+void Physics::allSolved(const btContactSolverInfo& info,
+                        btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc)
+{
+    if(!m_groups_solved)
+        return;
+    m_groups_solved = false;
+    if(m_island_solver && m_island_solver->hasIslands())
+        m_island_solver->solve(info, m_dispatcher);
+    handleManifolds();
+}   // allSolved
+
+// ----------------------------------------------------------------------------
+/** Stores the collisions of all contact manifolds in the collision lists,
+ *  and handles collisions of karts and objects with the track immediately.
+ */
+void Physics::handleManifolds()
+{
     int currentNumManifolds = m_dispatcher->getNumManifolds();
     // We can't explode a rocket in a loop, since a rocket might collide with
     // more than one object, and/or more than once with each object (if there
@@ -566,6 +633,9 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                 const btVector3 &normal = -contact_manifold->getContactPoint(0)
                                                             .m_normalWorldOnB;
                 kart->crashed(m, normal);
+                m_track_collisions.push_back(
+                    upB, contact_manifold->getContactPoint(0).m_localPointB,
+                    upA, contact_manifold->getContactPoint(0).m_localPointA);
             }
             else if(upB->is(UserPointer::UP_PHYSICAL_OBJECT))
             {
@@ -601,6 +671,9 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
                 const btVector3 &normal = contact_manifold->getContactPoint(0)
                                                            .m_normalWorldOnB;
                 kart->crashed(m, normal);   // Kart hit track
+                m_track_collisions.push_back(
+                    upA, contact_manifold->getContactPoint(0).m_localPointA,
+                    upB, contact_manifold->getContactPoint(0).m_localPointB);
             }
             else if(upB->is(UserPointer::UP_FLYABLE))
                 // 2.1 projectile hits kart
@@ -693,9 +766,72 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
         else
             assert("Unknown user pointer");           // 4) Should never happen
     }   // for i<numManifolds
+}   // handleManifolds
 
-    return returnValue;
-}   // solveGroup
+// ----------------------------------------------------------------------------
+/** Lists all collisions of the last step as collision events. Called after
+ *  the step, before the collisions are handled (which might e.g. remove a
+ *  flyable).
+ */
+void Physics::updateCollisionEvents()
+{
+    m_collision_events.clear();
+    for (const CollisionPair &p : m_all_collisions)
+    {
+        CollisionEvent e;
+        const UserPointer *a = p.getUserPointer(0);
+        const UserPointer *b = p.getUserPointer(1);
+        e.m_other = -1;
+        if (a->is(UserPointer::UP_KART))
+        {
+            const AbstractKart *kart = a->getPointerKart();
+            e.m_type     = COLLISION_KART_KART;
+            e.m_kart     = kart->getWorldKartId();
+            e.m_other    = b->getPointerKart()->getWorldKartId();
+            e.m_location = kart->getTrans()(p.getContactPointCS(0));
+        }
+        else if (a->is(UserPointer::UP_PHYSICAL_OBJECT) ||
+                 a->is(UserPointer::UP_ANIMATION))
+        {
+            const AbstractKart *kart = b->getPointerKart();
+            e.m_type     = COLLISION_KART_OBJECT;
+            e.m_kart     = kart->getWorldKartId();
+            e.m_location = kart->getTrans()(p.getContactPointCS(1));
+        }
+        else
+        {
+            Flyable *flyable = a->getPointerFlyable();
+            e.m_kart     = flyable->getOwnerId();
+            e.m_location = flyable->getXYZ();
+            if (b->is(UserPointer::UP_TRACK))
+                e.m_type = COLLISION_FLYABLE_TRACK;
+            else if (b->is(UserPointer::UP_PHYSICAL_OBJECT))
+                e.m_type = COLLISION_FLYABLE_OBJECT;
+            else if (b->is(UserPointer::UP_KART))
+            {
+                e.m_type  = COLLISION_FLYABLE_KART;
+                e.m_other = b->getPointerKart()->getWorldKartId();
+            }
+            else
+            {
+                e.m_type  = COLLISION_FLYABLE_FLYABLE;
+                e.m_other = b->getPointerFlyable()->getOwnerId();
+            }
+        }
+        m_collision_events.push_back(e);
+    }
+
+    // The track is not moved, so its local coordinates are world coordinates
+    for (const CollisionPair &p : m_track_collisions)
+    {
+        CollisionEvent e;
+        e.m_type     = COLLISION_KART_TRACK;
+        e.m_kart     = p.getUserPointer(0)->getPointerKart()->getWorldKartId();
+        e.m_other    = -1;
+        e.m_location = p.getContactPointCS(1);
+        m_collision_events.push_back(e);
+    }
+}   // updateCollisionEvents
 
 // ----------------------------------------------------------------------------
 /** A debug draw function to show the track and all karts.
@@ -25,6 +25,8 @@
   */
 
 #include <set>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "btBulletDynamicsCommon.h"
@@ -35,6 +37,7 @@
 #include "utils/singleton.hpp"
 
 class AbstractKart;
+class IslandSolver;
 class STKDynamicsWorld;
 class Vec3;
 
@@ -50,11 +53,9 @@ private:
      *  substep might be taken, resulting in potentially even more
      *  duplicates. To handle this, all collisions (i.e. pair of objects)
      *  are stored in a vector, but only one entry per collision pair
-     *  of objects.
-     *  While this is a natural application of std::set, the set has some
-     *  overhead (since it will likely use a tree to sort the entries).
-     *  Considering that the number of collisions is usually rather small
-     *  a simple list and linear search is faster is is being used here. */
+     *  of objects. The vector keeps the order in which collisions are
+     *  handled, a hash set of the pairs finds duplicates (a linear search
+     *  is quadratic in the number of collisions, e.g. at a crowded start). */
     class CollisionPair
     {
     private:
@@ -109,11 +110,27 @@ private:
     class CollisionList : public std::vector<CollisionPair>
     {
     private:
+        /** Hashes the (sorted) user pointers of a collision pair. */
+        struct PairHash
+        {
+            size_t operator()(const std::pair<const UserPointer*,
+                                              const UserPointer*> &p) const
+            {
+                size_t a = std::hash<const UserPointer*>()(p.first);
+                size_t b = std::hash<const UserPointer*>()(p.second);
+                return a ^ (b + 0x9e3779b9 + (a << 6) + (a >> 2));
+            }   // operator()
+        };   // PairHash
+
+        /** The objects of all pairs in this list. */
+        std::unordered_set<std::pair<const UserPointer*, const UserPointer*>,
+                           PairHash> m_pairs;
+
         void push_back(CollisionPair p) {
             // only add a pair if it's not already in there
-            for(iterator i=begin(); i!=end(); i++) {
-                if((*i)==p) return;
-            }
+            if(!m_pairs.insert(std::make_pair(p.getUserPointer(0),
+                                              p.getUserPointer(1))).second)
+                return;
             std::vector<CollisionPair>::push_back(p);
         };  // push_back
     public:
@@ -123,9 +140,46 @@ private:
         {
             push_back(CollisionPair(a, contact_point_a, b, contact_point_b));
         }
+        // --------------------------------------------------------------------
+        /** Removes all collisions. */
+        void clear()
+        {
+            std::vector<CollisionPair>::clear();
+            m_pairs.clear();
+        }   // clear
     };  // CollisionList
     // ========================================================================
 
+public:
+    /** The types of collisions reported as collision events. */
+    enum CollisionType
+    {
+        COLLISION_KART_KART,
+        COLLISION_KART_TRACK,
+        COLLISION_KART_OBJECT,
+        COLLISION_FLYABLE_KART,
+        COLLISION_FLYABLE_TRACK,
+        COLLISION_FLYABLE_OBJECT,
+        COLLISION_FLYABLE_FLYABLE
+    };
+
+    /** A collision of the last physics step, e.g. to penalize collisions
+     *  in a reward without comparing kart velocities. Each pair of objects
+     *  is reported at most once per step. */
+    struct CollisionEvent
+    {
+        CollisionType m_type;
+        /** World kart id of the kart, or of the owner of the flyable. */
+        int           m_kart;
+        /** World kart id of the other kart (kart-kart and flyable-kart
+         *  collisions), or of the owner of the other flyable, else -1. */
+        int           m_other;
+        /** Location of the collision in world coordinates. */
+        Vec3          m_location;
+    };
+
+private:
+
     /** This flag is set while bullets time step processing is taking
     *  place. It is used to avoid altering data structures that might
     *  be used (e.g. removing a kart while a loop over all karts is
@@ -145,15 +199,32 @@ private:
     IrrDebugDrawer                  *m_debug_drawer = NULL;
 
     btCollisionDispatcher           *m_dispatcher;
-    btBroadphaseInterface           *m_axis_sweep;
+    btBroadphaseInterface           *m_broadphase;
+
+    /** Solves the simulation islands on several threads, NULL if they
+     *  are solved by this (sequential) solver. */
+    IslandSolver                    *m_island_solver;
+
+    /** True if a group was solved since the collisions were last handled,
+     *  see allSolved. */
+    bool                             m_groups_solved;
     btDefaultCollisionConfiguration *m_collision_conf;
     CollisionList                    m_all_collisions;
 
+    /** Collisions of karts with the track. They are handled immediately,
+     *  and only listed to report them as collision events. */
+    CollisionList                    m_track_collisions;
+
+    /** All collisions of the last step. */
+    std::vector<CollisionEvent>      m_collision_events;
+
     /** Singleton. */
     static Physics                  *m_physics;
 
              Physics();
     virtual ~Physics();
+    void     updateCollisionEvents();
+    void     handleManifolds();
 
     // Give the singleton access to the constructor
     friend class AbstractSingleton<Physics>;
@@ -178,12 +249,25 @@ public:
     /** Returns true if the debug drawer is enabled. */
     bool  isDebug() const     {return m_debug_drawer->debugEnabled(); }
     IrrDebugDrawer* getDebugDrawer() { return m_debug_drawer; }
+    /** Returns all collisions of the last step. */
+    const std::vector<CollisionEvent>& getCollisionEvents() const
+    {
+        return m_collision_events;
+    }   // getCollisionEvents
+    // ------------------------------------------------------------------------
+    /** Removes the collision events once they are reported, so that they
+     *  are not reported again if the world is not updated (e.g. after the
+     *  race is over). */
+    void clearCollisionEvents() { m_collision_events.clear(); }
     virtual btScalar solveGroup(btCollisionObject** bodies, int numBodies,
                                 btPersistentManifold** manifold,int numManifolds,
                                 btTypedConstraint** constraints,int numConstraints,
                                 const btContactSolverInfo& info,
                                 btIDebugDraw* debugDrawer, btStackAlloc* stackAlloc,
                                 btDispatcher* dispatcher);
+    virtual void allSolved(const btContactSolverInfo& info,
+                           btIDebugDraw* debugDrawer,
+                           btStackAlloc* stackAlloc);
 };
 
 #endif // HEADER_PHYSICS_HPP
@@ -49,6 +49,26 @@ public:
     // ------------------------------------------------------------------------
     /** Gets the local time. */
     float getLocalTime() const { return m_localTime; }
+    // ------------------------------------------------------------------------
+    /** Simulates a time step as exactly num_substeps steps of equal size.
+     *  Like stepSimulation, but without accumulating time: rounding of the
+     *  substep size can never drop or add a substep. Forces apply to all
+     *  substeps and are cleared afterwards. */
+    void stepSubsteps(btScalar time_step, int num_substeps)
+    {
+        const btScalar substep = time_step / num_substeps;
+        saveKinematicState(time_step);
+        applyGravity();
+        for (int i = 0; i < num_substeps; i++)
+        {
+            internalSingleStepSimulation(substep);
+            synchronizeMotionStates();
+        }
+        clearForces();
+        // Reset the max speeds of all karts, see stepSimulation
+        for (int i = 0; i < m_actions.size(); i++)
+            m_actions[i]->resetMaxSpeed();
+    }   // stepSubsteps
 };   // STKDynamicsWorld
 #endif
 /* EOF */
@@ -19,14 +19,30 @@
 #include "physics/triangle_mesh.hpp"
 
 #include "config/stk_config.hpp"
+#include "io/file_manager.hpp"
 #include "physics/physics.hpp"
 #include "utils/constants.hpp"
+#include "utils/log.hpp"
 #include "utils/time.hpp"
 
 #include "btBulletDynamicsCommon.h"
 
+#include <cstdio>
 #include <fstream>
 
+#ifdef WIN32
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+/** Bullet stores triangle indices of a quantized bvh in 21 bits. */
+static const unsigned int MAX_QUANTIZED_TRIANGLES = 1 << 21;
+
 // -----------------------------------------------------------------------------
 /** Constructor: Initialises all data structures with zero.
  */
@@ -43,6 +59,9 @@ TriangleMesh::TriangleMesh(bool can_be_transformed) : m_mesh()
     // (and m_mesh->m_weldingThreshold at m_normals
     m_collision_shape  = NULL;
     m_collision_object = NULL;
+    m_bvh_data         = NULL;
+    m_bvh_size         = 0;
+    m_bvh_mapped       = false;
     m_user_pointer.set(this);
 }   // TriangleMesh
 
@@ -88,8 +107,9 @@ void TriangleMesh::addTriangle(const btVector3 &t1, const btVector3 &t2,
 // -----------------------------------------------------------------------------
 /** Creates a collision body only, which can be used for raycasting, but
  *  has no physical properties.
- *  @param serialized_bhv if non-null, load the serialized bhv from file instead
- *                        of builing it on the fly
+ *  @param serialized_bhv if non-null, load the serialized bhv from this file
+ *                        instead of building it on the fly. If the file does
+ *                        not exist, the bhv is built and saved to it.
  */
 void TriangleMesh::createCollisionShape(bool create_collision_object, const char* serialized_bhv)
 {
@@ -104,53 +124,27 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
     // Now convert the triangle mesh into a static rigid body
     btBvhTriangleMeshShape* bhv_triangle_mesh;
 
-    if (serialized_bhv != NULL)
+    if (serialized_bhv != NULL &&
+        m_triangleIndex2Material.size() < MAX_QUANTIZED_TRIANGLES)
     {
-        FILE *f = fopen(serialized_bhv, "rb");
-        fseek(f, 0, SEEK_END);
-        long pos = ftell(f);
-        assert(pos != -1L);
-        fseek(f, 0, SEEK_SET);
-
-        void* bytes = btAlignedAlloc(pos, 16);
-        fread(bytes, pos, 1, f);
-        fclose(f);
-
-        btOptimizedBvh* bhv = btOptimizedBvh::deSerializeInPlace(bytes, pos, !IS_LITTLE_ENDIAN);
+        // A serialized bhv always uses quantized aabbs, which makes the
+        // file and the tree in memory about four times smaller
+        btOptimizedBvh* bhv = loadBVH(serialized_bhv);
         if (bhv == NULL)
         {
-            Log::warn("TriangleMesh", "Failed to load serialized BHV");
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
+            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, true /* useQuantizedAabbCompression */);
+            saveBVH(serialized_bhv, bhv_triangle_mesh->getOptimizedBvh());
         }
         else
         {
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */,
+            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, true /* useQuantizedAabbCompression */,
                                                            false /* buildBvh */);
             bhv_triangle_mesh->setOptimizedBvh( bhv );
         }
-        // Do *NOT* free the bytes, 'deSerializeInPlace' makes the btOptimizedBvh object
-        // directly at this memory location
-        //free(bytes);
-
     }
     else
     {
         bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-
-        /*
-         // code to serialize triangle mesh
-        btOptimizedBvh* bvh = bhv_triangle_mesh->getOptimizedBvh();
-        unsigned int ssize = bvh->calculateSerializeBufferSize();
-        char* buffer = (char*)btAlignedAlloc(ssize, 16);
-        bool success = bvh->serialize(buffer, ssize, !IS_LITTLE_ENDIAN);
-        printf("serialization success = %i\n", success);
-
-        std::ofstream fileout("/tmp/btOptimizedBvh");
-        fileout.write(buffer, ssize);
-        fileout.close();
-
-        btAlignedFree(buffer);
-         */
     }
 
     m_collision_shape = bhv_triangle_mesh;
@@ -230,8 +224,162 @@ void TriangleMesh::removeAll()
     }
     delete m_collision_shape;
     m_collision_shape = NULL;
+    freeBVH();
 }   // removeAll
 
+// ----------------------------------------------------------------------------
+/** Returns a hash (64 bit FNV-1a) of all triangles of this mesh. */
+uint64_t TriangleMesh::getHash() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    const IndexedMeshArray &m = m_mesh.getIndexedMeshArray();
+    for (int i = 0; i < m.size(); i++)
+    {
+        const unsigned char *data = m[i].m_vertexBase;
+        size_t size = (size_t)m[i].m_numVertices * m[i].m_vertexStride;
+        for (size_t j = 0; j < size; j++)
+            hash = (hash ^ data[j]) * 1099511628211ULL;
+        data = m[i].m_triangleIndexBase;
+        size = (size_t)m[i].m_numTriangles * m[i].m_triangleIndexStride;
+        for (size_t j = 0; j < size; j++)
+            hash = (hash ^ data[j]) * 1099511628211ULL;
+    }
+    return hash;
+}   // getHash
+
+// ----------------------------------------------------------------------------
+/** Returns the file in which the bvh of this mesh is cached, or an empty
+ *  string if there is no cache directory. The name contains a hash of all
+ *  triangles and the bullet version, so a changed track or bullet version
+ *  never loads a stale tree.
+ */
+std::string TriangleMesh::getBVHCacheFile() const
+{
+    const std::string &dir = file_manager->getCachedBVHDir();
+    if (dir.empty() || m_triangleIndex2Material.size() == 0)
+        return "";
+    char name[64];
+    snprintf(name, sizeof(name), "%016llx-%d-%d.bvh",
+             (unsigned long long)getHash(), btGetVersion(),
+             (int)sizeof(btScalar));
+    return dir + name;
+}   // getBVHCacheFile
+
+// ----------------------------------------------------------------------------
+/** Loads a serialized bvh. On posix systems the file is mapped copy-on-write,
+ *  so processes that load the same track share the memory of the tree.
+ *  \param file The file to load.
+ *  \return The bvh, or NULL if the file does not exist or is invalid.
+ */
+btOptimizedBvh* TriangleMesh::loadBVH(const char *file)
+{
+    assert(m_bvh_data == NULL);
+#ifdef WIN32
+    FILE *f = fopen(file, "rb");
+    if (!f)
+        return NULL;
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < (long)sizeof(btOptimizedBvh))
+    {
+        fclose(f);
+        return NULL;
+    }
+    m_bvh_data = btAlignedAlloc(size, 16);
+    m_bvh_size = size;
+    m_bvh_mapped = false;
+    bool read = fread(m_bvh_data, size, 1, f) == 1;
+    fclose(f);
+    if (!read)
+    {
+        freeBVH();
+        return NULL;
+    }
+#else
+    int fd = open(file, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(btOptimizedBvh))
+    {
+        close(fd);
+        return NULL;
+    }
+    // Deserializing writes the object header, all other pages stay shared
+    void *data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+    m_bvh_data = data;
+    m_bvh_size = st.st_size;
+    m_bvh_mapped = true;
+#endif
+
+    // Check the size before deserializing, which asserts on a wrong size
+    btOptimizedBvh *bvh = (btOptimizedBvh*)m_bvh_data;
+    if (IS_LITTLE_ENDIAN && bvh->calculateSerializeBufferSize() != m_bvh_size)
+    {
+        Log::warn("TriangleMesh", "Ignoring invalid bvh '%s'.", file);
+        freeBVH();
+        return NULL;
+    }
+    bvh = btOptimizedBvh::deSerializeInPlace(m_bvh_data, (unsigned)m_bvh_size,
+                                             !IS_LITTLE_ENDIAN);
+    if (bvh == NULL || !bvh->isQuantized())
+    {
+        Log::warn("TriangleMesh", "Ignoring invalid bvh '%s'.", file);
+        freeBVH();
+        return NULL;
+    }
+    return bvh;
+}   // loadBVH
+
+// ----------------------------------------------------------------------------
+/** Saves a bvh. The file is written under a temporary name first and then
+ *  renamed, so that other processes never read a partially written file.
+ *  \param file The file to write.
+ *  \param bvh The bvh to save.
+ */
+void TriangleMesh::saveBVH(const char *file, btOptimizedBvh *bvh) const
+{
+    unsigned int size = bvh->calculateSerializeBufferSize();
+    void *buffer = btAlignedAlloc(size, 16);
+    if (bvh->serialize(buffer, size, !IS_LITTLE_ENDIAN))
+    {
+        std::string tmp = std::string(file) + "." +
+                          std::to_string(getpid()) + ".tmp";
+        FILE *f = fopen(tmp.c_str(), "wb");
+        bool written = f && fwrite(buffer, size, 1, f) == 1;
+        if (f)
+            fclose(f);
+        if (!written || rename(tmp.c_str(), file) != 0)
+        {
+            Log::warn("TriangleMesh", "Can not write bvh '%s'.", file);
+            remove(tmp.c_str());
+        }
+    }
+    btAlignedFree(buffer);
+}   // saveBVH
+
+// ----------------------------------------------------------------------------
+/** Frees the memory of a deserialized bvh. */
+void TriangleMesh::freeBVH()
+{
+    if (m_bvh_data == NULL)
+        return;
+#ifndef WIN32
+    if (m_bvh_mapped)
+        munmap(m_bvh_data, m_bvh_size);
+    else
+#endif
+        btAlignedFree(m_bvh_data);
+    m_bvh_data = NULL;
+    m_bvh_size = 0;
+    m_bvh_mapped = false;
+}   // freeBVH
+
 // -----------------------------------------------------------------------------
 /** Interpolates the normal at the given position for the triangle with
  *  a given index. The position must be inside of the given triangle.
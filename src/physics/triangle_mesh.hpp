@@ -19,6 +19,8 @@
 #ifndef HEADER_TRIANGLE_MESH_HPP
 #define HEADER_TRIANGLE_MESH_HPP
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include "btBulletDynamicsCommon.h"
 
@@ -57,6 +59,19 @@ private:
      *  to the current transform of the body. */
     bool m_can_be_transformed;
 
+    /** The memory a deserialized bvh lives in, NULL if the bvh was built. */
+    void                        *m_bvh_data;
+
+    /** Size of m_bvh_data in bytes. */
+    size_t                       m_bvh_size;
+
+    /** True if m_bvh_data is a mapped file, false if it was allocated. */
+    bool                         m_bvh_mapped;
+
+    btOptimizedBvh *loadBVH(const char *file);
+    void            saveBVH(const char *file, btOptimizedBvh *bvh) const;
+    void            freeBVH();
+
 public:
     class RigidBodyTriangleMesh : public btRigidBody
     {
@@ -83,6 +98,8 @@ public:
                             const char* serializedBhv = NULL);
     void removeAll();
     void removeCollisionObject();
+    uint64_t getHash() const;
+    std::string getBVHCacheFile() const;
     btVector3 getInterpolatedNormal(unsigned int index,
                                     const btVector3 &position) const;
     // ------------------------------------------------------------------------
@@ -0,0 +1,248 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "race/race_context.hpp"
+
+#include "config/stk_config.hpp"
+#include "graphics/camera.hpp"
+#include "graphics/weather.hpp"
+#include "items/item_manager.hpp"
+#include "items/powerup_manager.hpp"
+#include "items/projectile_manager.hpp"
+#include "modes/world.hpp"
+#include "physics/physics.hpp"
+#include "race/race_manager.hpp"
+#include "scriptengine/property_animator.hpp"
+#include "scriptengine/script_engine.hpp"
+#include "tracks/check_manager.hpp"
+#include "tracks/graph.hpp"
+#include "tracks/track.hpp"
+#include "tracks/track_manager.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+RaceContext               *RaceContext::m_current = NULL;
+std::vector<RaceContext*>  RaceContext::m_all_contexts;
+
+/** Minor mode and number of karts the powerup weights were computed for. */
+static std::pair<int, int> g_powerup_weights(-1, -1);
+
+// ----------------------------------------------------------------------------
+/** Creates the context of a new race, with its own race manager and
+ *  projectile manager. All other managers are created when the race is
+ *  started. The new context is not activated.
+ */
+RaceContext::RaceContext() : RaceContext(false)
+{
+    m_race_manager       = new RaceManager();
+    m_projectile_manager = new ProjectileManager();
+    m_projectile_manager->loadData();
+    m_all_contexts.push_back(this);
+}   // RaceContext
+
+// ----------------------------------------------------------------------------
+RaceContext::RaceContext(bool is_default)
+{
+    m_is_default          = is_default;
+    m_world               = NULL;
+    m_physics             = NULL;
+    m_script_engine       = NULL;
+    m_weather             = NULL;
+    m_property_animator   = NULL;
+    m_item_random_seed    = 0;
+    m_powerup_random_seed = 0;
+    m_race_manager        = NULL;
+    m_projectile_manager  = NULL;
+    m_track               = NULL;
+    m_graph               = NULL;
+    m_check_manager       = NULL;
+    m_active_camera       = NULL;
+    m_private_track       = NULL;
+}   // RaceContext
+
+// ----------------------------------------------------------------------------
+/** Deletes the world of this race (if any) and all managers owned by this
+ *  context, and activates the default context again.
+ */
+RaceContext::~RaceContext()
+{
+    assert(!m_is_default);
+    std::lock_guard<std::recursive_mutex> lock(getLock());
+    activate();
+    if (World::getWorld())
+        race_manager->exitRace();
+
+    // Capture everything that was not deleted with the world, then switch
+    // back before deleting the managers of this race.
+    capture();
+    RaceContext *def = getDefault();
+    def->install();
+    m_current = def;
+    m_all_contexts.erase(std::find(m_all_contexts.begin(),
+                                   m_all_contexts.end(), this));
+
+    delete m_race_manager;
+    delete m_projectile_manager;
+    delete m_property_animator;
+    delete m_private_track;
+}   // ~RaceContext
+
+// ----------------------------------------------------------------------------
+/** Returns the context that holds the managers created at startup. It is
+ *  active whenever no race is. */
+RaceContext *RaceContext::getDefault()
+{
+    static RaceContext *default_context = NULL;
+    if (!default_context)
+    {
+        default_context = new RaceContext(true);
+        default_context->capture();
+        if (!m_current)
+            m_current = default_context;
+    }
+    return default_context;
+}   // getDefault
+
+// ----------------------------------------------------------------------------
+/** The lock that has to be held while a context is active and used. */
+std::recursive_mutex &RaceContext::getLock()
+{
+    static std::recursive_mutex lock;
+    return lock;
+}   // getLock
+
+// ----------------------------------------------------------------------------
+/** Makes this context the active one: the state of the previously active
+ *  context is saved in that context, and the state of this one is installed
+ *  in all global variables and singletons. The caller must hold getLock().
+ */
+void RaceContext::activate()
+{
+    RaceContext *previous = m_current ? m_current : getDefault();
+    if (previous == this)
+        return;
+    previous->capture();
+    install();
+    m_current = this;
+}   // activate
+
+// ----------------------------------------------------------------------------
+/** Saves the current global state in this context. */
+void RaceContext::capture()
+{
+    m_world               = World::getWorld();
+    m_physics             = Physics::m_singleton;
+    m_script_engine       = Scripting::ScriptEngine::m_singleton;
+    m_weather             = Weather::m_singleton;
+    m_property_animator   = PropertyAnimator::s_instance;
+    m_item_manager        = ItemManager::m_item_manager;
+    m_item_random_engine  = ItemManager::m_random_engine;
+    m_item_random_seed    = ItemManager::m_random_seed;
+    m_powerup_random_seed = powerup_manager ? powerup_manager->getRandomSeed()
+                                            : 0;
+    m_race_manager        = race_manager;
+    m_projectile_manager  = projectile_manager;
+    m_track               = Track::m_current_track;
+    m_graph               = Graph::m_graph;
+    m_check_manager       = CheckManager::m_check_manager;
+    m_cameras             = Camera::m_all_cameras;
+    m_active_camera       = Camera::s_active_camera;
+
+    // The powerup weights currently in use are the ones of this race
+    if (m_world && m_race_manager)
+    {
+        g_powerup_weights = std::make_pair((int)m_race_manager->getMinorMode(),
+                                   (int)m_race_manager->getNumberOfKarts());
+    }
+}   // capture
+
+// ----------------------------------------------------------------------------
+/** Installs the state of this context in the global variables. */
+void RaceContext::install() const
+{
+    World::setWorld(m_world);
+    Physics::m_singleton                  = m_physics;
+    Scripting::ScriptEngine::m_singleton  = m_script_engine;
+    Weather::m_singleton                  = m_weather;
+    // PropertyAnimator::get creates the animator of a new race
+    PropertyAnimator::s_instance          = m_property_animator;
+    ItemManager::m_item_manager           = m_item_manager;
+    ItemManager::m_random_engine          = m_item_random_engine;
+    ItemManager::m_random_seed            = m_item_random_seed;
+    race_manager                          = m_race_manager;
+    projectile_manager                    = m_projectile_manager;
+    // All ticks of a race are counted at the physics rate of the race
+    if (m_race_manager)
+        stk_config->setPhysicsFPS(m_race_manager->getPhysicsFPS());
+    Track::m_current_track                = m_track;
+    Graph::m_graph                        = m_graph;
+    CheckManager::m_check_manager         = m_check_manager;
+    Camera::m_all_cameras                 = m_cameras;
+    Camera::s_active_camera               = m_active_camera;
+    if (powerup_manager)
+    {
+        powerup_manager->setRandomSeed(m_powerup_random_seed);
+        // The powerup weights depend on the race mode and number of karts
+        std::pair<int, int> weights(-1, -1);
+        if (m_world && m_race_manager)
+        {
+            weights = std::make_pair((int)m_race_manager->getMinorMode(),
+                                     (int)m_race_manager->getNumberOfKarts());
+        }
+        if (m_world && weights != g_powerup_weights)
+        {
+            powerup_manager->computeWeightsForRace(weights.second);
+            g_powerup_weights = weights;
+        }
+    }
+}   // install
+
+// ----------------------------------------------------------------------------
+/** Returns the track to use for a new race in the active context. Tracks
+ *  keep their loaded models, physics and item data in the Track object, so
+ *  if another race has this track loaded already, the active context gets a
+ *  private copy of it.
+ *  \param ident Identifier of the track.
+ */
+Track *RaceContext::getTrack(const std::string &ident)
+{
+    Track *track = track_manager->getTrack(ident);
+    if (!track || !m_current || m_current->m_is_default)
+        return track;
+
+    bool in_use = false;
+    for (RaceContext *context : m_all_contexts)
+    {
+        if (context != m_current && context->m_track == track)
+            in_use = true;
+    }
+    if (!in_use)
+        return track;
+
+    RaceContext *current = m_current;
+    if (current->m_private_track &&
+        current->m_private_track->getIdent() != ident)
+    {
+        delete current->m_private_track;
+        current->m_private_track = NULL;
+    }
+    if (!current->m_private_track)
+        current->m_private_track = new Track(track->getFilename());
+    return current->m_private_track;
+}   // getTrack
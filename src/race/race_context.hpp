@@ -0,0 +1,106 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_RACE_CONTEXT_HPP
+#define HEADER_RACE_CONTEXT_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <vector>
+
+class Camera;
+class CheckManager;
+class Graph;
+class ItemManager;
+class Physics;
+class ProjectileManager;
+class PropertyAnimator;
+class RaceManager;
+class Track;
+class Weather;
+class World;
+namespace Scripting { class ScriptEngine; }
+
+/** \brief All per-race global state of SuperTuxKart.
+ *  SuperTuxKart keeps the world, physics, items, track, race manager and
+ *  the animations of track scripts in process-wide singletons. A RaceContext owns one set of them, and
+ *  activate() swaps them in, which allows several races to live in one
+ *  process and share all loaded assets (karts, materials, item models).
+ *  Only one context is active at a time: callers hold getLock() while they
+ *  use a context, so races on different threads take turns: contexts
+ *  isolate the state of races, they do not step races concurrently.
+ *  \ingroup race
+ */
+class RaceContext : public NoCopy
+{
+private:
+    World                            *m_world;
+    Physics                          *m_physics;
+    Scripting::ScriptEngine          *m_script_engine;
+    Weather                          *m_weather;
+    PropertyAnimator                 *m_property_animator;
+    std::shared_ptr<ItemManager>      m_item_manager;
+    std::mt19937                      m_item_random_engine;
+    uint32_t                          m_item_random_seed;
+    uint64_t                          m_powerup_random_seed;
+    RaceManager                      *m_race_manager;
+    ProjectileManager                *m_projectile_manager;
+    Track                            *m_track;
+    Graph                            *m_graph;
+    CheckManager                     *m_check_manager;
+    std::vector<Camera*>              m_cameras;
+    Camera                           *m_active_camera;
+
+    /** A private copy of the track, used if another race has the same
+     *  track loaded already. */
+    Track                            *m_private_track;
+
+    /** True for the context that holds the managers created at startup. */
+    bool                              m_is_default;
+
+    static RaceContext               *m_current;
+    static std::vector<RaceContext*>  m_all_contexts;
+
+    explicit RaceContext(bool is_default);
+    void     capture();
+    void     install() const;
+
+public:
+             RaceContext();
+            ~RaceContext();
+    void     activate();
+    // ------------------------------------------------------------------------
+    static Track       *getTrack(const std::string &ident);
+    static RaceContext *getDefault();
+    static std::recursive_mutex &getLock();
+    // ------------------------------------------------------------------------
+    /** Returns the number of races with their own context. */
+    static unsigned int getNumRaces()
+    {
+        return (unsigned int)m_all_contexts.size();
+    }   // getNumRaces
+    // ------------------------------------------------------------------------
+    /** Returns the active context, NULL if the startup context is active. */
+    static RaceContext *getCurrent() { return m_current; }
+};   // RaceContext
+
+#endif
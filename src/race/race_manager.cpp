@@ -55,8 +55,11 @@ RaceManager::RaceManager()
     m_coin_target        = 0;
     m_num_local_players = 0;
     m_hit_capture_limit = 0;
-    m_flag_return_ticks = stk_config->time2Ticks(20.0f);
-    m_flag_deactivated_ticks = stk_config->time2Ticks(3.0f);
+    m_physics_broadphase = PB_AXIS_SWEEP;
+    m_physics_threads   = 1;
+    m_physics_substeps  = 1;
+    m_physics_solver_iterations = 0;
+    setPhysicsFPS(stk_config->getDefaultPhysicsFPS());
     setMaxGoal(0);
     setTimeTarget(0.0f);
     setReverseTrack(false);
@@ -67,6 +70,18 @@ RaceManager::RaceManager()
     setSpareTireKartNum(0);
 }   // RaceManager
 
+//-----------------------------------------------------------------------------
+/** Sets the rate of physics and game logic ticks of this race. The flag
+ *  timeouts are stored in ticks, so they are converted again.
+ *  \param fps Ticks per second.
+ */
+void RaceManager::setPhysicsFPS(int fps)
+{
+    m_physics_fps            = fps;
+    m_flag_return_ticks      = 20 * fps;
+    m_flag_deactivated_ticks = 3 * fps;
+}   // setPhysicsFPS
+
 //-----------------------------------------------------------------------------
 /** Destructor for the race manager.
  */
@@ -347,6 +362,11 @@ void RaceManager::startNextRace()
         }
     }
 
+    // Load the models of all karts in this race (if they are loaded lazily)
+    // before the track pushes its temporary materials.
+    for (unsigned int i=0;i<m_kart_status.size();i++)
+        kart_properties_manager->loadKartModels(m_kart_status[i].m_ident);
+
     // the constructor assigns this object to the global
     // variable world. Admittedly a bit ugly, but simplifies
     // handling of objects which get created in the constructor
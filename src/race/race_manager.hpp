@@ -209,6 +209,10 @@ public:
      *  spare tire karts which allow gain life in battle mode */
     enum KartType       { KT_PLAYER, KT_AI, KT_LEADER,
                           KT_SPARE_TIRE };
+
+    /** Broadphase of the physics world: sweep and prune over the track
+     *  bounds, or a dynamic AABB tree (faster with many moving objects). */
+    enum PhysicsBroadphase { PB_AXIS_SWEEP, PB_DBVT };
 public:
 
     /** This data structure accumulates kart data and race result data from
@@ -298,6 +302,22 @@ private:
     float                            m_time_target;
     int                              m_goal_target;
     int                              m_hit_capture_limit;
+
+    /** The broadphase used by the physics of the race. */
+    PhysicsBroadphase                m_physics_broadphase;
+
+    /** Number of threads that solve the simulation islands, 1 solves
+     *  them all in the main thread. */
+    int                              m_physics_threads;
+
+    /** Ticks per second of the physics and game logic of this race. */
+    int                              m_physics_fps;
+
+    /** Number of bullet steps per tick. */
+    int                              m_physics_substeps;
+
+    /** Number of solver iterations, 0 uses the value of stk_config. */
+    int                              m_physics_solver_iterations;
     void startNextRace();    // start a next race
 
     friend bool operator< (const KartStatus& left, const KartStatus& right)
@@ -369,6 +389,28 @@ public:
         m_num_laps = num;
     }   // setNumLaps
     // ------------------------------------------------------------------------
+    void setPhysicsBroadphase(PhysicsBroadphase broadphase)
+    {
+        m_physics_broadphase = broadphase;
+    }   // setPhysicsBroadphase
+    // ------------------------------------------------------------------------
+    void setPhysicsThreads(int threads)
+    {
+        m_physics_threads = threads;
+    }   // setPhysicsThreads
+    // ------------------------------------------------------------------------
+    void setPhysicsFPS(int fps);
+    // ------------------------------------------------------------------------
+    void setPhysicsSubsteps(int substeps)
+    {
+        m_physics_substeps = substeps;
+    }   // setPhysicsSubsteps
+    // ------------------------------------------------------------------------
+    void setPhysicsSolverIterations(int iterations)
+    {
+        m_physics_solver_iterations = iterations;
+    }   // setPhysicsSolverIterations
+    // ------------------------------------------------------------------------
     void setReverseTrack(bool r_t)
     {
         m_reverse_track = r_t;
@@ -463,6 +505,22 @@ public:
     /** \return whether the track should be reversed */
     bool getReverseTrack() const { return m_reverse_track; }
     // ------------------------------------------------------------------------
+    PhysicsBroadphase getPhysicsBroadphase() const
+    {
+        return m_physics_broadphase;
+    }   // getPhysicsBroadphase
+    // ------------------------------------------------------------------------
+    int getPhysicsThreads() const { return m_physics_threads; }
+    // ------------------------------------------------------------------------
+    int getPhysicsFPS() const { return m_physics_fps; }
+    // ------------------------------------------------------------------------
+    int getPhysicsSubsteps() const { return m_physics_substeps; }
+    // ------------------------------------------------------------------------
+    int getPhysicsSolverIterations() const
+    {
+        return m_physics_solver_iterations;
+    }   // getPhysicsSolverIterations
+    // ------------------------------------------------------------------------
     /** Returns the difficulty. */
     Difficulty getDifficulty() const { return m_difficulty; }
     // ------------------------------------------------------------------------
@@ -487,6 +545,14 @@ public:
     // ------------------------------------------------------------------------
     unsigned int getFinishedPlayers() const { return m_num_finished_players; }
     // ------------------------------------------------------------------------
+    /** Sets the number of finished karts and players, used when a race
+     *  snapshot is restored. */
+    void setFinishedKarts(unsigned int karts, unsigned int players)
+    {
+        m_num_finished_karts   = karts;
+        m_num_finished_players = players;
+    }   // setFinishedKarts
+    // ------------------------------------------------------------------------
     const std::string& getKartIdent(int kart) const
     {
         return m_kart_status[kart].m_ident;
@@ -60,6 +60,8 @@ class PropertyAnimator
 {
     PtrVector<AnimatedProperty> m_properties;
     static PropertyAnimator* s_instance;
+    // Each race animates its own properties
+    friend class RaceContext;
 public:
 
     static PropertyAnimator* get();
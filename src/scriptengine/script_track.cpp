@@ -104,6 +104,11 @@ namespace Scripting
 
         void createTextBillboard(std::string* text, SimpleVec3* location)
         {
+#ifndef SERVER_ONLY
+            // No fonts are loaded without graphics
+            if (CVS->isNoGraphics())
+                return;
+#endif
             core::stringw wtext = StringUtils::utf8ToWide(*text);
             DigitFace* digit_face = font_manager->getFont<DigitFace>();
             core::vector3df xyz(location->getX(), location->getY(), location->getZ());
@@ -79,7 +79,7 @@ void ArenaGraph::differentNodeColor(int n, video::SColor* c) const
 // -----------------------------------------------------------------------------
 void ArenaGraph::loadNavmesh(const std::string &navmesh)
 {
-    XMLNode *xml = file_manager->createXMLTree(navmesh);
+    XMLNode *xml = file_manager->createCachedXMLTree(navmesh);
     if (xml->getName() != "navmesh")
     {
         Log::error("ArenaGraph", "NavMesh is invalid.");
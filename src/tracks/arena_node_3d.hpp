@@ -40,6 +40,11 @@ public:
         return BoundingBox3D::pointInside(p);
     }
     // ------------------------------------------------------------------------
+    virtual bool getBoundingBox2D(Vec3 *min, Vec3 *max) const OVERRIDE
+    {
+        return BoundingBox3D::getBoundingBox2D(min, max);
+    }
+    // ------------------------------------------------------------------------
     virtual bool is3DQuad() const OVERRIDE                     { return true; }
 
 };
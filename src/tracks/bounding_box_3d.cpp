@@ -0,0 +1,154 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/bounding_box_3d.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /** A vector in double precision, the planes of the faces can be far
+     *  away from the origin. */
+    struct Vector
+    {
+        double x, y, z;
+        Vector(double x_, double y_, double z_) : x(x_), y(y_), z(z_) {}
+        Vector(const Vec3 &v) : x(v.getX()), y(v.getY()), z(v.getZ()) {}
+        Vector operator-(const Vector &o) const
+        {
+            return Vector(x - o.x, y - o.y, z - o.z);
+        }
+        Vector operator+(const Vector &o) const
+        {
+            return Vector(x + o.x, y + o.y, z + o.z);
+        }
+        Vector operator*(double f) const { return Vector(x*f, y*f, z*f); }
+        double dot(const Vector &o) const { return x*o.x + y*o.y + z*o.z; }
+        Vector cross(const Vector &o) const
+        {
+            return Vector(y*o.z - z*o.y, z*o.x - x*o.z, x*o.y - y*o.x);
+        }
+        double length() const { return sqrt(dot(*this)); }
+    };   // Vector
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Computes the x/z bounding box of all points for which pointInside returns
+ *  true. pointInside accepts a point if it is on the same side of all six
+ *  face planes, i.e. if it is in the intersection of the six half spaces on
+ *  the inner side of the faces, or in the intersection of the six half spaces
+ *  on the outer side. Both are convex, and if they are bounded, their
+ *  vertices are intersections of three face planes. Faces of a twisted quad
+ *  are not planar, so these vertices are not necessarily corners of the box.
+ *  The only other points accepted are the ones exactly on the plane of the
+ *  top face (where the sign test is 0), which have no area and are ignored.
+ *  \param min On return the minimum x and z coordinate (y is not set).
+ *  \param max On return the maximum x and z coordinate (y is not set).
+ *  \return False if the accepted points are not bounded.
+ */
+bool BoundingBox3D::getBoundingBox2D(Vec3 *min, Vec3 *max) const
+{
+    std::vector<Vector> normals, points;
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        Vector p0(m_box_faces[i][0]);
+        normals.push_back((Vector(m_box_faces[i][1]) - p0)
+                          .cross(Vector(m_box_faces[i][2]) - p0));
+        points.push_back(p0);
+    }
+    // A degenerated top face accepts every point
+    if (normals[0].length() == 0.0)
+        return false;
+
+    // Start with the corners of the box, the vertices are added below
+    *min = m_box_faces[0][0];
+    *max = m_box_faces[0][0];
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        min->min(m_box_faces[0][i]); max->max(m_box_faces[0][i]);
+        min->min(m_box_faces[2][i]); max->max(m_box_faces[2][i]);
+    }
+
+    for (int sign = -1; sign <= 1; sign += 2)
+    {
+        // The half spaces are unbounded if a direction exists in which no
+        // plane is crossed. If there is one, there is one along an
+        // intersection of two planes.
+        bool any_intersection = false;
+        for (unsigned int i = 0; i < 6; i++)
+        {
+            for (unsigned int j = i + 1; j < 6; j++)
+            {
+                Vector d = normals[i].cross(normals[j]);
+                if (d.length() == 0.0)
+                    continue;
+                any_intersection = true;
+                for (int dir = -1; dir <= 1; dir += 2)
+                {
+                    bool crosses_plane = false;
+                    for (unsigned int k = 0; k < 6 && !crosses_plane; k++)
+                    {
+                        double tolerance = 1e-9 * normals[k].length()
+                                         * d.length();
+                        crosses_plane = sign * dir * normals[k].dot(d)
+                                      < -tolerance;
+                    }
+                    if (!crosses_plane)
+                        return false;
+                }
+            }
+        }
+        if (!any_intersection)
+            return false;
+
+        // Add all intersections of three planes that are inside (with some
+        // tolerance, an additional vertex only makes the box bigger).
+        for (unsigned int i = 0; i < 6; i++)
+        {
+            for (unsigned int j = i + 1; j < 6; j++)
+            {
+                for (unsigned int k = j + 1; k < 6; k++)
+                {
+                    const Vector &a = normals[i], &b = normals[j],
+                                 &c = normals[k];
+                    double det = a.dot(b.cross(c));
+                    if (fabs(det) <= 1e-12 * a.length() * b.length()
+                                            * c.length())
+                        continue;
+                    Vector v = (b.cross(c) * a.dot(points[i]) +
+                                c.cross(a) * b.dot(points[j]) +
+                                a.cross(b) * c.dot(points[k])) * (1.0 / det);
+                    bool inside = true;
+                    for (unsigned int m = 0; m < 6 && inside; m++)
+                    {
+                        inside = sign * normals[m].dot(v - points[m])
+                               >= -0.01 * normals[m].length();
+                    }
+                    if (!inside)
+                        continue;
+                    Vec3 vertex((float)v.x, (float)v.y, (float)v.z);
+                    min->min(vertex);
+                    max->max(vertex);
+                }
+            }
+        }
+    }   // for sign
+    return true;
+}   // getBoundingBox2D
@@ -78,6 +78,8 @@ public:
         }
         return true;
     }
+    // ------------------------------------------------------------------------
+    bool getBoundingBox2D(Vec3 *min, Vec3 *max) const;
 
 };
 
@@ -26,6 +26,7 @@
 #include "modes/world.hpp"
 #include "race/race_manager.hpp"
 #include "tracks/check_manager.hpp"
+#include "utils/snapshot.hpp"
 
 CheckCylinder::CheckCylinder(const XMLNode &node,
                              std::function<void(int)> triggering_function)
@@ -80,3 +81,19 @@ bool CheckCylinder::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
 
     return triggered;
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+void CheckCylinder::saveState(Snapshot *s) const
+{
+    CheckStructure::saveState(s);
+    for (unsigned int i = 0; i < m_is_inside.size(); i++)
+        s->add((bool)m_is_inside[i]);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckCylinder::restoreState(Snapshot *s)
+{
+    CheckStructure::restoreState(s);
+    for (unsigned int i = 0; i < m_is_inside.size(); i++)
+        m_is_inside[i] = s->get<bool>();
+}   // restoreState
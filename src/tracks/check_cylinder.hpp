@@ -24,6 +24,7 @@
 
 class XMLNode;
 class CheckManager;
+class Snapshot;
 class TriggerItemListener;
 
 /** This class implements a check sphere that is used to change the ambient
@@ -55,6 +56,8 @@ public:
     virtual     ~CheckCylinder() {};
     virtual bool isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
                              int kart_id);
+    virtual void saveState(Snapshot *s) const;
+    virtual void restoreState(Snapshot *s);
     // ------------------------------------------------------------------------
     /** Returns if kart indx is currently inside of the sphere. */
     bool isInside(int index) const            { return m_is_inside[index]; }
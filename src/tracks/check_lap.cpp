@@ -25,6 +25,7 @@
 #include "modes/linear_world.hpp"
 #include "race/race_manager.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot.hpp"
 
 /** Constructor for a lap line.
  *  \param check_manager Pointer to the check manager, which is needed when
@@ -87,3 +88,19 @@ bool CheckLap::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
 
     return result;
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+void CheckLap::saveState(Snapshot *s) const
+{
+    CheckStructure::saveState(s);
+    for (unsigned int i = 0; i < m_previous_distance.size(); i++)
+        s->add(m_previous_distance[i]);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckLap::restoreState(Snapshot *s)
+{
+    CheckStructure::restoreState(s);
+    for (unsigned int i = 0; i < m_previous_distance.size(); i++)
+        s->get(&m_previous_distance[i]);
+}   // restoreState
@@ -24,6 +24,7 @@
 
 class XMLNode;
 class CheckManager;
+class Snapshot;
 
 /**
  *  \brief Implements a simple lap test. A new lap is detected
@@ -42,6 +43,8 @@ public:
     virtual     ~CheckLap() {};
     virtual bool isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
                              int indx) OVERRIDE;
+    virtual void saveState(Snapshot *s) const OVERRIDE;
+    virtual void restoreState(Snapshot *s) OVERRIDE;
     virtual void reset(const Track &track) OVERRIDE;
     virtual bool triggeringCheckline() const OVERRIDE { return true; }
 };   // CheckLine
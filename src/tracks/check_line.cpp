@@ -28,6 +28,7 @@
 #include "modes/world.hpp"
 
 #include "race/race_manager.hpp"
+#include "utils/snapshot.hpp"
 
 #include "irrlicht.h"
 
@@ -178,3 +179,19 @@ bool CheckLine::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
     }
     return result;
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+void CheckLine::saveState(Snapshot *s) const
+{
+    CheckStructure::saveState(s);
+    for (unsigned int i = 0; i < m_previous_sign.size(); i++)
+        s->add((bool)m_previous_sign[i]);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckLine::restoreState(Snapshot *s)
+{
+    CheckStructure::restoreState(s);
+    for (unsigned int i = 0; i < m_previous_sign.size(); i++)
+        m_previous_sign[i] = s->get<bool>();
+}   // restoreState
@@ -30,6 +30,7 @@ using namespace irr;
 
 class XMLNode;
 class CheckManager;
+class Snapshot;
 
 namespace SP
 {
@@ -87,6 +88,8 @@ public:
     virtual     ~CheckLine();
     virtual bool isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
                              int indx) OVERRIDE;
+    virtual void saveState(Snapshot *s) const OVERRIDE;
+    virtual void restoreState(Snapshot *s) OVERRIDE;
     virtual void reset(const Track &track) OVERRIDE;
     virtual void resetAfterKartMove(unsigned int kart_index) OVERRIDE;
     virtual void changeDebugColor(bool is_active) OVERRIDE;
@@ -32,6 +32,7 @@
 #include "tracks/check_structure.hpp"
 #include "tracks/drive_graph.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot.hpp"
 
 CheckManager *CheckManager::m_check_manager = NULL;
 
@@ -119,6 +120,21 @@ void CheckManager::reset(const Track &track)
         (*i)->reset(track);
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the per-kart state of all checks. */
+void CheckManager::saveState(Snapshot *s) const
+{
+    for (const CheckStructure *check : m_all_checks)
+        check->saveState(s);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckManager::restoreState(Snapshot *s)
+{
+    for (CheckStructure *check : m_all_checks)
+        check->restoreState(s);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Called after a kart is moved (e.g. after a rescue) to reset any cached
  *  check information. Without this an incorrect crossing of a checkline
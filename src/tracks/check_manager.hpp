@@ -28,6 +28,7 @@
 class AbstractKart;
 class CheckStructure;
 class Flyable;
+class Snapshot;
 class Track;
 class XMLNode;
 class Vec3;
@@ -41,6 +42,7 @@ class CheckManager : public NoCopy
 private:
     std::vector<CheckStructure*> m_all_checks;
     static CheckManager         *m_check_manager;
+    friend class RaceContext;
            /** Private constructor, to make sure it is only called via
             *  the static create function. */
            CheckManager()       {m_all_checks.clear();};
@@ -52,6 +54,8 @@ public:
     void   load(const XMLNode &node);
     void   update(float dt);
     void   reset(const Track &track);
+    void   saveState(Snapshot *s) const;
+    void   restoreState(Snapshot *s);
     void   resetAfterKartMove(AbstractKart *kart);
     unsigned int getLapLineIndex() const;
     int    getChecklineTriggering(const Vec3 &from, const Vec3 &to) const;
@@ -24,6 +24,7 @@
 #include "io/xml_node.hpp"
 #include "modes/world.hpp"
 #include "race/race_manager.hpp"
+#include "utils/snapshot.hpp"
 
 /** Constructor for a checksphere.
  *  \param check_manager Pointer to the check manager, which is needed when
@@ -71,3 +72,19 @@ bool CheckSphere::isTriggered(const Vec3 &old_pos, const Vec3 &new_pos,
     return (old_dist2>=m_radius2 && new_dist2 < m_radius2) ||
            (old_dist2< m_radius2 && new_dist2 >=m_radius2);
 }   // isTriggered
+
+// ----------------------------------------------------------------------------
+void CheckSphere::saveState(Snapshot *s) const
+{
+    CheckStructure::saveState(s);
+    for (unsigned int i = 0; i < m_is_inside.size(); i++)
+        s->add((bool)m_is_inside[i]);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckSphere::restoreState(Snapshot *s)
+{
+    CheckStructure::restoreState(s);
+    for (unsigned int i = 0; i < m_is_inside.size(); i++)
+        m_is_inside[i] = s->get<bool>();
+}   // restoreState
@@ -26,6 +26,7 @@
 #include "race/race_manager.hpp"
 #include "tracks/check_lap.hpp"
 #include "tracks/check_manager.hpp"
+#include "utils/snapshot.hpp"
 
 #include <algorithm>
 
@@ -93,6 +94,28 @@ void CheckStructure::reset(const Track &track)
     }   // for i<getNumKarts
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the per-kart state of this check structure.
+ */
+void CheckStructure::saveState(Snapshot *s) const
+{
+    for (unsigned int i = 0; i < m_is_active.size(); i++)
+    {
+        s->add(m_previous_position[i]);
+        s->add((bool)m_is_active[i]);
+    }
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void CheckStructure::restoreState(Snapshot *s)
+{
+    for (unsigned int i = 0; i < m_is_active.size(); i++)
+    {
+        m_previous_position[i] = s->getVec3();
+        m_is_active[i] = s->get<bool>();
+    }
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Updates all check structures. Called one per time step.
  *  \param dt Time since last call.
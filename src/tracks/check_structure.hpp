@@ -25,6 +25,7 @@
 #include "utils/vec3.hpp"
 
 class CheckManager;
+class Snapshot;
 class Track;
 class XMLNode;
 
@@ -122,6 +123,8 @@ public:
                              int indx)=0;
     virtual void trigger(unsigned int kart_index);
     virtual void reset(const Track &track);
+    virtual void saveState(Snapshot *s) const;
+    virtual void restoreState(Snapshot *s);
 
     // ------------------------------------------------------------------------
     /** Returns the type of this check structure. */
@@ -90,7 +90,7 @@ void DriveGraph::getPoint(const XMLNode *xml,
 void DriveGraph::load(const std::string &quad_file_name,
                       const std::string &filename)
 {
-    XMLNode *quad = file_manager->createXMLTree(quad_file_name);
+    XMLNode *quad = file_manager->createCachedXMLTree(quad_file_name);
     if (!quad || quad->getName() != "quads")
     {
         Log::error("DriveGraph : Quad xml '%s' not found.", filename.c_str());
@@ -157,7 +157,7 @@ void DriveGraph::load(const std::string &quad_file_name,
     }
     delete quad;
 
-    const XMLNode *xml = file_manager->createXMLTree(filename);
+    const XMLNode *xml = file_manager->createCachedXMLTree(filename);
 
     if(!xml)
     {
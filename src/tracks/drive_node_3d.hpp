@@ -48,6 +48,11 @@ public:
         return BoundingBox3D::pointInside(p);
     }
     // ------------------------------------------------------------------------
+    virtual bool getBoundingBox2D(Vec3 *min, Vec3 *max) const OVERRIDE
+    {
+        return BoundingBox3D::getBoundingBox2D(min, max);
+    }
+    // ------------------------------------------------------------------------
     virtual void getDistances(const Vec3 &xyz, Vec3 *result) const OVERRIDE;
     // ------------------------------------------------------------------------
     virtual float getDistance2FromPoint(const Vec3 &xyz) const OVERRIDE;
@@ -32,6 +32,10 @@
 #include "tracks/track.hpp"
 #include "utils/log.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 const int Graph::UNKNOWN_SECTOR = -1;
 const float Graph::MIN_HEIGHT_TESTING = -1.0f;
 const float Graph::MAX_HEIGHT_TESTING = 5.0f;
@@ -47,6 +51,9 @@ Graph::Graph()
     m_bb_min      = Vec3( 99999,  99999,  99999);
     m_bb_max      = Vec3(-99999, -99999, -99999);
     memset(m_bb_nodes, 0, 4 * sizeof(int));
+    m_grid_min_x  = m_grid_min_z  = 0.0f;
+    m_grid_cell_x = m_grid_cell_z = 1.0f;
+    m_grid_size_x = m_grid_size_z = 0;
 }  // Graph
 
 // -----------------------------------------------------------------------------
@@ -480,6 +487,38 @@ void Graph::findRoadSector(const Vec3& xyz, int *sector,
     // the current one
     int indx       = *sector;
 
+    if (!all_sectors && !m_grid_inside_start.empty())
+    {
+        // Only the nodes of the cell can contain the point. They are tested
+        // in the same order as all nodes below: starting after the current
+        // sector, and wrapping around.
+        *sector = UNKNOWN_SECTOR;
+        const unsigned int cell = getGridCellZ(xyz.getZ()) * m_grid_size_x
+                                + getGridCellX(xyz.getX());
+        const int *begin = m_grid_inside_nodes.data()
+                         + m_grid_inside_start[cell];
+        const int *end   = m_grid_inside_nodes.data()
+                         + m_grid_inside_start[cell + 1];
+        const int *split = std::upper_bound(begin, end, indx);
+        for (const int *i = split; i != end; i++)
+        {
+            if (getQuad(*i)->pointInside(xyz, ignore_vertical))
+            {
+                *sector = *i;
+                return;
+            }
+        }
+        for (const int *i = begin; i != split; i++)
+        {
+            if (getQuad(*i)->pointInside(xyz, ignore_vertical))
+            {
+                *sector = *i;
+                return;
+            }
+        }
+        return;
+    }
+
     // If a current sector is given, and max_lookahead is specify, only test
     // the next max_lookahead quads instead of testing the whole graph.
     // This is necessary for the AI: if the track contains a loop, e.g.:
@@ -576,6 +615,18 @@ int Graph::findOutOfRoadSector(const Vec3& xyz, const int curr_sector,
     // it always comes back with some kind of quad.
     for(int phase=0; phase<2; phase++)
     {
+        if (!all_sectors && !m_grid_quad_start.empty())
+        {
+            // The grid finds the same node as the loop below, which tests
+            // all nodes starting after current_sector.
+            int first = (current_sector + 1) % (int)getNumNodes();
+            if (first < 0) first += getNumNodes();
+            min_sector = findClosestNode(xyz, first, phase == 0,
+                                         ignore_vertical);
+            if (min_sector != UNKNOWN_SECTOR)
+                return min_sector;
+            continue;
+        }
         for(int j=0; j<count; j++)
         {
             int next_sector;
@@ -624,6 +675,7 @@ int Graph::findOutOfRoadSector(const Vec3& xyz, const int curr_sector,
 //-----------------------------------------------------------------------------
 void Graph::loadBoundingBoxNodes()
 {
+    buildGrid();
     m_bb_nodes[0] = findOutOfRoadSector(Vec3(m_bb_min.x(), 0, m_bb_min.z()),
         -1/*curr_sector*/, NULL/*all_sectors*/, true/*ignore_vertical*/);
     m_bb_nodes[1] = findOutOfRoadSector(Vec3(m_bb_min.x(), 0, m_bb_max.z()),
@@ -633,3 +685,259 @@ void Graph::loadBoundingBoxNodes()
     m_bb_nodes[3] = findOutOfRoadSector(Vec3(m_bb_max.x(), 0, m_bb_max.z()),
         -1/*curr_sector*/, NULL/*all_sectors*/, true/*ignore_vertical*/);
 }   // loadBoundingBoxNodes
+
+//-----------------------------------------------------------------------------
+/** Builds the grid used by findRoadSector and findOutOfRoadSector. The cell
+ *  size is chosen so that there is about one cell per node.
+ */
+void Graph::buildGrid()
+{
+    m_grid_inside_start.clear();
+    m_grid_inside_nodes.clear();
+    m_grid_quad_start.clear();
+    m_grid_quad_nodes.clear();
+    m_grid_quad_range.clear();
+    const unsigned int num_nodes = getNumNodes();
+    if (num_nodes == 0)
+        return;
+
+    // Rounding errors in pointInside and in the computation of the cells are
+    // covered by making the bounds of all nodes a bit bigger.
+    const Vec3 margin(2.0f, 0.0f, 2.0f);
+
+    // The bounds of the quads (which contain their drivelines), and of the
+    // points for which pointInside can be true.
+    std::vector<Vec3> quad_min(num_nodes), quad_max(num_nodes);
+    std::vector<Vec3> inside_min(num_nodes), inside_max(num_nodes);
+    std::vector<bool> bounded(num_nodes);
+    Vec3 grid_min = (*m_all_nodes[0])[0] - margin;
+    Vec3 grid_max = (*m_all_nodes[0])[0] + margin;
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        const Quad &q = *m_all_nodes[i];
+        quad_min[i] = q[0];
+        quad_max[i] = q[0];
+        for (unsigned int j = 1; j < 4; j++)
+        {
+            quad_min[i].min(q[j]);
+            quad_max[i].max(q[j]);
+        }
+        quad_min[i] -= margin;
+        quad_max[i] += margin;
+        grid_min.min(quad_min[i]);
+        grid_max.max(quad_max[i]);
+
+        // The grid only covers the quads: the points of a twisted 3d quad
+        // can reach much further, the cells at the border of the grid
+        // include everything outside of it.
+        bounded[i] = q.getBoundingBox2D(&inside_min[i], &inside_max[i]);
+        if (bounded[i])
+        {
+            inside_min[i] -= margin;
+            inside_max[i] += margin;
+        }
+    }
+
+    const float size_x = grid_max.getX() - grid_min.getX();
+    const float size_z = grid_max.getZ() - grid_min.getZ();
+    const float cell   = sqrtf(size_x * size_z / num_nodes);
+    m_grid_min_x  = grid_min.getX();
+    m_grid_min_z  = grid_min.getZ();
+    m_grid_size_x = std::max(1, std::min((int)(size_x / cell), 1024));
+    m_grid_size_z = std::max(1, std::min((int)(size_z / cell), 1024));
+    m_grid_cell_x = size_x / m_grid_size_x;
+    m_grid_cell_z = size_z / m_grid_size_z;
+
+    // The cells covered by each node. A node that can contain points
+    // anywhere is added to all cells.
+    std::vector<int> range(4 * num_nodes);
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        range[4*i  ] = bounded[i] ? getGridCellX(inside_min[i].getX()) : 0;
+        range[4*i+1] = bounded[i] ? getGridCellX(inside_max[i].getX())
+                                  : m_grid_size_x - 1;
+        range[4*i+2] = bounded[i] ? getGridCellZ(inside_min[i].getZ()) : 0;
+        range[4*i+3] = bounded[i] ? getGridCellZ(inside_max[i].getZ())
+                                  : m_grid_size_z - 1;
+    }
+    fillGridCells(range, &m_grid_inside_start, &m_grid_inside_nodes);
+
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        range[4*i  ] = getGridCellX(quad_min[i].getX());
+        range[4*i+1] = getGridCellX(quad_max[i].getX());
+        range[4*i+2] = getGridCellZ(quad_min[i].getZ());
+        range[4*i+3] = getGridCellZ(quad_max[i].getZ());
+    }
+    fillGridCells(range, &m_grid_quad_start, &m_grid_quad_nodes);
+    m_grid_quad_range.swap(range);
+}   // buildGrid
+
+//-----------------------------------------------------------------------------
+/** Adds each node to the cells of a range, in increasing order of the nodes.
+ *  \param range For each node the first and last column, and the first and
+ *         last row of the cells it is added to.
+ *  \param start On return the index of the first node of each cell.
+ *  \param nodes On return the nodes of all cells.
+ */
+void Graph::fillGridCells(const std::vector<int> &range,
+                          std::vector<unsigned int> *start,
+                          std::vector<int> *nodes) const
+{
+    const unsigned int num_nodes = (unsigned int)range.size() / 4;
+    // Count the nodes of each cell first
+    start->assign(m_grid_size_x * m_grid_size_z + 1, 0);
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        for (int z = range[4*i+2]; z <= range[4*i+3]; z++)
+        {
+            for (int x = range[4*i]; x <= range[4*i+1]; x++)
+                (*start)[z * m_grid_size_x + x + 1]++;
+        }
+    }
+    for (unsigned int i = 1; i < start->size(); i++)
+        (*start)[i] += (*start)[i - 1];
+
+    std::vector<unsigned int> next(start->begin(), start->end() - 1);
+    nodes->resize(start->back());
+    for (unsigned int i = 0; i < num_nodes; i++)
+    {
+        for (int z = range[4*i+2]; z <= range[4*i+3]; z++)
+        {
+            for (int x = range[4*i]; x <= range[4*i+1]; x++)
+                (*nodes)[next[z * m_grid_size_x + x]++] = i;
+        }
+    }
+}   // fillGridCells
+
+//-----------------------------------------------------------------------------
+/** Returns the grid column of an x coordinate. Coordinates outside of the
+ *  grid are mapped to the closest column. */
+int Graph::getGridCellX(float x) const
+{
+    const float cell = (x - m_grid_min_x) / m_grid_cell_x;
+    // The negated test also handles NaN
+    if (!(cell >= 0.0f))
+        return 0;
+    if (cell >= (float)m_grid_size_x)
+        return m_grid_size_x - 1;
+    return (int)cell;
+}   // getGridCellX
+
+//-----------------------------------------------------------------------------
+/** Returns the grid row of a z coordinate. Coordinates outside of the grid
+ *  are mapped to the closest row. */
+int Graph::getGridCellZ(float z) const
+{
+    const float cell = (z - m_grid_min_z) / m_grid_cell_z;
+    if (!(cell >= 0.0f))
+        return 0;
+    if (cell >= (float)m_grid_size_z)
+        return m_grid_size_z - 1;
+    return (int)cell;
+}   // getGridCellZ
+
+//-----------------------------------------------------------------------------
+/** Finds the node that one phase of findOutOfRoadSector would find, using
+ *  the grid. The cells are searched in squares of increasing size around
+ *  the point, until no node outside of the square can be closer than the
+ *  closest node found so far. Of nodes with the same distance the one that
+ *  comes first in the order of findOutOfRoadSector is returned.
+ *  \param xyz The point.
+ *  \param first The node that findOutOfRoadSector tests first.
+ *  \param test_height True for the first phase, which only accepts nodes
+ *         close to the height of the point.
+ *  \param ignore_vertical Accept nodes independent of height.
+ */
+int Graph::findClosestNode(const Vec3 &xyz, int first, bool test_height,
+                           bool ignore_vertical) const
+{
+    const int num_nodes = getNumNodes();
+    const int cx        = getGridCellX(xyz.getX());
+    const int cz        = getGridCellZ(xyz.getZ());
+    int   min_sector    = UNKNOWN_SECTOR;
+    int   min_order     = num_nodes;
+    float min_dist_2    = 999999.0f*999999.0f;
+
+    for (int r = 0; ; r++)
+    {
+        const int z_start = std::max(cz - r, 0);
+        const int z_end   = std::min(cz + r, m_grid_size_z - 1);
+        for (int z = z_start; z <= z_end; z++)
+        {
+            // The inside of the square was searched in the previous rounds
+            const int step = (z == cz - r || z == cz + r) ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += step)
+            {
+                if (x < 0 || x >= m_grid_size_x)
+                    continue;
+                const unsigned int cell = z * m_grid_size_x + x;
+                for (unsigned int j = m_grid_quad_start[cell];
+                     j < m_grid_quad_start[cell + 1]; j++)
+                {
+                    const int i   = m_grid_quad_nodes[j];
+                    const Quad *q = m_all_nodes[i];
+                    if (q->isIgnored())
+                        continue;
+                    // A node is in several cells, test it only in the cell
+                    // closest to the point (which is in the first square
+                    // that contains any of its cells).
+                    const int *range = &m_grid_quad_range[4 * i];
+                    if (x != std::min(std::max(cx, range[0]), range[1]) ||
+                        z != std::min(std::max(cz, range[2]), range[3]))
+                        continue;
+                    const float dist_2 = q->getDistance2FromPoint(xyz);
+                    const int order = i >= first ? i - first
+                                                 : i - first + num_nodes;
+                    if (!(dist_2 < min_dist_2 ||
+                          (dist_2 == min_dist_2 &&
+                           min_sector != UNKNOWN_SECTOR && order < min_order)))
+                        continue;
+                    const float dist = xyz.getY() - q->getMinHeight();
+                    if (test_height && !(dist < 5.0f && dist > -1.0f) &&
+                        !q->is3DQuad() && !ignore_vertical)
+                        continue;
+                    min_dist_2 = dist_2;
+                    min_sector = i;
+                    min_order  = order;
+                }
+            }
+        }
+
+        // All nodes not tested yet are outside of the square, so at least
+        // as far away as the closest side of the square that is not at the
+        // border of the grid.
+        bool  all_tested = true;
+        float bound      = std::numeric_limits<float>::max();
+        if (cx - r > 0)
+        {
+            bound = std::min(bound, xyz.getX() -
+                             (m_grid_min_x + (cx - r) * m_grid_cell_x));
+            all_tested = false;
+        }
+        if (cx + r < m_grid_size_x - 1)
+        {
+            bound = std::min(bound, m_grid_min_x +
+                             (cx + r + 1) * m_grid_cell_x - xyz.getX());
+            all_tested = false;
+        }
+        if (cz - r > 0)
+        {
+            bound = std::min(bound, xyz.getZ() -
+                             (m_grid_min_z + (cz - r) * m_grid_cell_z));
+            all_tested = false;
+        }
+        if (cz + r < m_grid_size_z - 1)
+        {
+            bound = std::min(bound, m_grid_min_z +
+                             (cz + r + 1) * m_grid_cell_z - xyz.getZ());
+            all_tested = false;
+        }
+        if (all_tested)
+            break;
+        if (min_sector != UNKNOWN_SECTOR && bound > 0.0f &&
+            bound * bound > min_dist_2)
+            break;
+    }
+    return min_sector;
+}   // findClosestNode
@@ -54,6 +54,8 @@ class Graph : public NoCopy
 protected:
     static Graph* m_graph;
 
+    friend class RaceContext;
+
     std::vector<Quad*> m_all_nodes;
 
     // ------------------------------------------------------------------------
@@ -75,6 +77,29 @@ private:
     /** The 4 closest graph nodes to the bounding box. */
     int m_bb_nodes[4];
 
+    /** A uniform grid over the x/z bounds of all nodes, used to find the
+     *  nodes close to a point without testing all nodes. */
+    float m_grid_min_x, m_grid_min_z;
+    float m_grid_cell_x, m_grid_cell_z;
+    int   m_grid_size_x, m_grid_size_z;
+
+    /** For each cell, all nodes (in increasing order) for which pointInside
+     *  can be true for a point in the cell. m_grid_inside_start contains the
+     *  index of the first node of each cell in m_grid_inside_nodes, and one
+     *  additional entry for the end of the last cell. Empty if there is no
+     *  grid. */
+    std::vector<unsigned int> m_grid_inside_start;
+    std::vector<int>          m_grid_inside_nodes;
+
+    /** For each cell, all nodes whose quad (and so its driveline) overlaps
+     *  the cell, stored the same way. */
+    std::vector<unsigned int> m_grid_quad_start;
+    std::vector<int>          m_grid_quad_nodes;
+
+    /** The first and last column, and the first and last row of the cells
+     *  of each node in m_grid_quad_nodes. */
+    std::vector<int>          m_grid_quad_range;
+
     /** The node of the graph mesh. */
     scene::ISceneNode *m_node;
 
@@ -103,6 +128,19 @@ private:
     // ------------------------------------------------------------------------
     void cleanupDebugMesh();
     // ------------------------------------------------------------------------
+    void buildGrid();
+    // ------------------------------------------------------------------------
+    void fillGridCells(const std::vector<int> &range,
+                       std::vector<unsigned int> *start,
+                       std::vector<int> *nodes) const;
+    // ------------------------------------------------------------------------
+    int  getGridCellX(float x) const;
+    // ------------------------------------------------------------------------
+    int  getGridCellZ(float z) const;
+    // ------------------------------------------------------------------------
+    int  findClosestNode(const Vec3 &xyz, int first, bool test_height,
+                         bool ignore_vertical) const;
+    // ------------------------------------------------------------------------
     virtual bool hasLapLine() const = 0;
     // ------------------------------------------------------------------------
     virtual void differentNodeColor(int n, video::SColor* c) const = 0;
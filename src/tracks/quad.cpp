@@ -141,3 +141,46 @@ bool Quad::pointInside(const Vec3& p, bool ignore_vertical) const
                p.sideOfLine2D(m_p[3], m_p[0]) >= 0.0;
     }
 }   // pointInside
+
+// ----------------------------------------------------------------------------
+/** Computes the x/z bounding box of all points for which pointInside can
+ *  return true (for any height). pointInside splits the quad along the
+ *  diagonal 0-2 and accepts points on the inner side of the three edges of
+ *  either triangle. That is exactly the triangle if its points are in the
+ *  order pointInside expects, otherwise points far away can be accepted.
+ *  Very thin triangles are not accepted either, since rounding errors in
+ *  pointInside can then accept points some distance away from them.
+ *  \param min On return the minimum x and z coordinate (y is not set).
+ *  \param max On return the maximum x and z coordinate (y is not set).
+ *  \return False if the accepted points are not bounded by the quad.
+ */
+bool Quad::getBoundingBox2D(Vec3 *min, Vec3 *max) const
+{
+    *min = m_p[0];
+    *max = m_p[0];
+    for (unsigned int i = 1; i < 4; i++)
+    {
+        min->min(m_p[i]);
+        max->max(m_p[i]);
+    }
+
+    // Twice the area of the triangles 0,1,2 and 2,3,0, positive if the
+    // points are in the expected order.
+    const float area[2] = { m_p[2].sideOfLine2D(m_p[0], m_p[1]),
+                            m_p[0].sideOfLine2D(m_p[2], m_p[3]) };
+    const int triangle[2][3] = { { 0, 1, 2 }, { 2, 3, 0 } };
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        float longest_2 = 0.0f;
+        for (unsigned int j = 0; j < 3; j++)
+        {
+            const Vec3 edge = m_p[triangle[i][(j + 1) % 3]]
+                            - m_p[triangle[i][j]];
+            longest_2 = std::max(longest_2, edge.getX() * edge.getX() +
+                                            edge.getZ() * edge.getZ());
+        }
+        if (!(area[i] > 0.001f * longest_2))
+            return false;
+    }
+    return true;
+}   // getBoundingBox2D
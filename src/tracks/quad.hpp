@@ -117,6 +117,8 @@ public:
     virtual bool pointInside(const Vec3& p,
                              bool ignore_vertical = false) const;
     // ------------------------------------------------------------------------
+    virtual bool getBoundingBox2D(Vec3 *min, Vec3 *max) const;
+    // ------------------------------------------------------------------------
     /** Returns true if this quad is 3D, which additional 3D testing is used in
      *  pointInside. */
     virtual bool is3DQuad() const                             { return false; }
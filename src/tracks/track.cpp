@@ -65,6 +65,7 @@
 #include "tracks/drive_graph.hpp"
 #include "tracks/drive_node.hpp"
 #include "tracks/model_definition_loader.hpp"
+#include "tracks/track_cache.hpp"
 #include "tracks/track_manager.hpp"
 #include "tracks/track_object_manager.hpp"
 #include "utils/constants.hpp"
@@ -700,8 +701,15 @@ void Track::createPhysicsModel(unsigned int main_track_count)
         convertTrackToBullet(m_all_nodes[i]);
         uploadNodeVertexBuffer(m_all_nodes[i]);
     }
-    m_track_mesh->createPhysicalBody(m_friction);
-    m_gfx_effect_mesh->createCollisionShape();
+    // The collision trees only depend on the triangles of the track, so they
+    // are cached on disk
+    std::string track_bvh = m_track_mesh->getBVHCacheFile();
+    std::string gfx_bvh   = m_gfx_effect_mesh->getBVHCacheFile();
+    m_track_mesh->createPhysicalBody(m_friction,
+        (btCollisionObject::CollisionFlags)0,
+        track_bvh.empty() ? NULL : track_bvh.c_str());
+    m_gfx_effect_mesh->createCollisionShape(/*create_collision_object*/true,
+        gfx_bvh.empty() ? NULL : gfx_bvh.c_str());
 }   // createPhysicsModel
 
 // -----------------------------------------------------------------------------
@@ -1485,7 +1493,7 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
     // Soccer field with navmesh requires it
     // for two goal line to be drawn them in minimap
     std::string path = m_root + m_all_modes[mode_id].m_scene;
-    XMLNode *root    = file_manager->createXMLTree(path);
+    XMLNode *root    = file_manager->createCachedXMLTree(path);
 
     // Make sure that we have a track (which is used for raycasts to
     // place other objects).
@@ -1497,6 +1505,14 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
         throw std::runtime_error(msg.str());
     }
 
+    // If the track is not cached yet, remember which meshes were loaded
+    // before, so that all meshes loaded for this track can be cached.
+    const bool add_to_cache = TrackCache::isEnabled() &&
+                              !TrackCache::use(m_filename);
+    std::set<scene::IAnimatedMesh*> previous_meshes;
+    if (add_to_cache)
+        previous_meshes = TrackCache::getAllCachedMeshes();
+
     m_current_track = this;
 
     // Load the graph only now: this function is called from world, after
@@ -1836,6 +1852,9 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
         easter_world->readData(dir+"/easter_eggs.xml");
     }
 
+    if (add_to_cache)
+        TrackCache::add(m_filename, previous_meshes);
+
     STKTexManager::getInstance()->unsetTextureErrorMessage();
 #ifndef SERVER_ONLY
     if (CVS->isGLSL())
@@ -68,6 +68,8 @@ private:
      *  NULL otherwise. */
     static Track *m_current_track;
 
+    friend class RaceContext;
+
 #ifdef DEBUG
     unsigned int             m_magic_number;
 #endif
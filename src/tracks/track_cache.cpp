@@ -0,0 +1,187 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/track_cache.hpp"
+
+#include "graphics/irr_driver.hpp"
+#include "graphics/stk_texture.hpp"
+#include "utils/log.hpp"
+
+#include <IAnimatedMesh.h>
+#include <IMeshCache.h>
+#include <ISceneManager.h>
+
+std::list<TrackCache::Entry> TrackCache::m_entries;
+size_t                       TrackCache::m_budget = 0;
+size_t                       TrackCache::m_size   = 0;
+
+// ----------------------------------------------------------------------------
+/** Sets the memory budget of the cache. Tracks are evicted until the cache
+ *  fits, a budget of 0 frees all cached tracks and disables the cache.
+ *  \param budget Maximum memory of all cached meshes in bytes.
+ */
+void TrackCache::setBudget(size_t budget)
+{
+    m_budget = budget;
+    evict();
+}   // setBudget
+
+// ----------------------------------------------------------------------------
+/** Marks a track as most recently used.
+ *  \param filename File name of the track.
+ *  \return True if the meshes of the track are cached.
+ */
+bool TrackCache::use(const std::string &filename)
+{
+    for (auto it = m_entries.begin(); it != m_entries.end(); it++)
+    {
+        if (it->m_filename == filename)
+        {
+            m_entries.splice(m_entries.begin(), m_entries, it);
+            return true;
+        }
+    }
+    return false;
+}   // use
+
+// ----------------------------------------------------------------------------
+/** Returns all meshes in irrlicht's mesh cache. Called before a track is
+ *  loaded, so that add() can find the meshes the track loaded.
+ */
+std::set<scene::IAnimatedMesh*> TrackCache::getAllCachedMeshes()
+{
+    std::set<scene::IAnimatedMesh*> meshes;
+    scene::IMeshCache *cache = irr_driver->getSceneManager()->getMeshCache();
+    for (unsigned int i = 0; i < cache->getMeshCount(); i++)
+        meshes.insert(cache->getMeshByIndex(i));
+    return meshes;
+}   // getAllCachedMeshes
+
+// ----------------------------------------------------------------------------
+/** Adds a track that was just loaded as the most recently used one, and
+ *  evicts other tracks if the budget is exceeded.
+ *  \param filename File name of the track.
+ *  \param previous All meshes in irrlicht's mesh cache before the track was
+ *         loaded (see getAllCachedMeshes). All other meshes are kept.
+ */
+void TrackCache::add(const std::string &filename,
+                     const std::set<scene::IAnimatedMesh*> &previous)
+{
+    Entry entry;
+    entry.m_filename = filename;
+    entry.m_size     = 0;
+    scene::IMeshCache *cache = irr_driver->getSceneManager()->getMeshCache();
+    for (unsigned int i = 0; i < cache->getMeshCount(); i++)
+    {
+        scene::IAnimatedMesh *am = cache->getMeshByIndex(i);
+        if (previous.find(am) != previous.end())
+            continue;
+        // The track keeps the mesh of the first frame (which is the
+        // animated mesh itself for skinned and SP meshes), and removes
+        // the animated mesh from the cache once it holds the last
+        // reference. So hold a reference to that mesh as well.
+        scene::IMesh *mesh = am->getMesh(0);
+        if (!mesh)
+            continue;
+        mesh->grab();
+        irr_driver->grabAllTextures(mesh);
+        entry.m_meshes.push_back(mesh);
+        entry.m_size += getMeshSize(mesh);
+    }
+    Log::info("TrackCache", "Caching %u meshes (%.1f MB) of '%s'.",
+              (unsigned int)entry.m_meshes.size(),
+              entry.m_size / (1024.0f * 1024.0f), filename.c_str());
+    m_size += entry.m_size;
+    m_entries.push_front(entry);
+    evict();
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Frees all cached tracks. Called before irrlicht is shut down. */
+void TrackCache::clear()
+{
+    for (Entry &entry : m_entries)
+        freeEntry(entry);
+    m_entries.clear();
+    m_size = 0;
+}   // clear
+
+// ----------------------------------------------------------------------------
+/** Evicts the least recently used tracks until the cache fits the budget.
+ *  The most recently used track is only evicted if the cache is disabled.
+ */
+void TrackCache::evict()
+{
+    while (!m_entries.empty() &&
+           (m_budget == 0 || (m_size > m_budget && m_entries.size() > 1)))
+    {
+        Entry &entry = m_entries.back();
+        Log::info("TrackCache", "Evicting '%s'.", entry.m_filename.c_str());
+        m_size -= entry.m_size;
+        freeEntry(entry);
+        m_entries.pop_back();
+    }
+}   // evict
+
+// ----------------------------------------------------------------------------
+/** Drops the references of an entry. Meshes that are not used by any race
+ *  are removed from irrlicht's mesh cache, like in Track::cleanup.
+ */
+void TrackCache::freeEntry(Entry &entry)
+{
+    for (scene::IMesh *mesh : entry.m_meshes)
+    {
+        irr_driver->dropAllTextures(mesh);
+        if (mesh->getReferenceCount() == 1)
+        {
+            mesh->drop();
+            continue;
+        }
+        mesh->drop();
+        if (mesh->getReferenceCount() == 1)
+            irr_driver->removeMeshFromCache(mesh);
+    }
+    entry.m_meshes.clear();
+}   // freeEntry
+
+// ----------------------------------------------------------------------------
+/** Returns the approximate memory used by the vertices, indices and the
+ *  textures of a mesh in bytes. Textures of SP meshes are managed by the
+ *  SP texture manager and are not counted.
+ */
+size_t TrackCache::getMeshSize(const scene::IMesh *mesh)
+{
+    size_t size = 0;
+    for (unsigned int i = 0; i < mesh->getMeshBufferCount(); i++)
+    {
+        const scene::IMeshBuffer *mb = mesh->getMeshBuffer(i);
+        size += mb->getVertexCount() *
+                video::getVertexPitchFromType(mb->getVertexType());
+        size += mb->getIndexCount() *
+                (mb->getIndexType() == video::EIT_16BIT ? 2 : 4);
+        const video::SMaterial &m = mb->getMaterial();
+        for (unsigned int j = 0; j < video::MATERIAL_MAX_TEXTURES; j++)
+        {
+            const STKTexture *t =
+                dynamic_cast<const STKTexture*>(m.getTexture(j));
+            if (t)
+                size += t->getTextureSize();
+        }
+    }
+    return size;
+}   // getMeshSize
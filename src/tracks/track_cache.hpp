@@ -0,0 +1,93 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_TRACK_CACHE_HPP
+#define HEADER_TRACK_CACHE_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <cstddef>
+#include <list>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace irr
+{
+    namespace scene { class IAnimatedMesh; class IMesh; }
+}
+using namespace irr;
+
+/** \brief Keeps the meshes of recently used tracks loaded between races.
+ *  Track::cleanup removes all meshes of a track from irrlicht's mesh cache,
+ *  so every race reloads them from disk. The track cache holds a reference
+ *  to all meshes (and their textures and GL buffers) a track loaded, which
+ *  keeps them in irrlicht's mesh cache. Tracks are evicted least recently
+ *  used first once the cached meshes exceed the memory budget. The cache is
+ *  disabled (budget 0) by default.
+ *  \ingroup tracks
+ */
+class TrackCache : public NoCopy
+{
+private:
+    /** The meshes of one track. */
+    struct Entry
+    {
+        /** File name of the track (Track::getFilename). */
+        std::string                 m_filename;
+        /** All meshes loaded by the track, each holds one reference. */
+        std::vector<scene::IMesh*>  m_meshes;
+        /** Approximate memory used by the meshes in bytes. */
+        size_t                      m_size;
+    };
+
+    /** All cached tracks, the most recently used one first. */
+    static std::list<Entry> m_entries;
+
+    /** Maximum memory of all cached meshes in bytes, 0 disables the cache. */
+    static size_t           m_budget;
+
+    /** Approximate memory used by all cached meshes in bytes. */
+    static size_t           m_size;
+
+    static void   freeEntry(Entry &entry);
+    static void   evict();
+    static size_t getMeshSize(const scene::IMesh *mesh);
+
+public:
+    static void   setBudget(size_t budget);
+    static bool   use(const std::string &filename);
+    static void   add(const std::string &filename,
+                      const std::set<scene::IAnimatedMesh*> &previous);
+    static std::set<scene::IAnimatedMesh*> getAllCachedMeshes();
+    static void   clear();
+    // ------------------------------------------------------------------------
+    /** Returns true if tracks are kept loaded between races. */
+    static bool   isEnabled() { return m_budget > 0; }
+    // ------------------------------------------------------------------------
+    /** Returns the memory budget in bytes. */
+    static size_t getBudget() { return m_budget; }
+    // ------------------------------------------------------------------------
+    /** Returns the approximate memory used by all cached tracks in bytes. */
+    static size_t getSize() { return m_size; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of cached tracks. */
+    static unsigned int getNumTracks() { return (unsigned int)m_entries.size(); }
+};   // TrackCache
+
+#endif
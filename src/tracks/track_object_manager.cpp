@@ -27,6 +27,7 @@
 #include "physics/physical_object.hpp"
 #include "tracks/track_object.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot.hpp"
 
 #include <IMeshSceneNode.h>
 #include <ISceneManager.h>
@@ -104,6 +105,28 @@ void TrackObjectManager::reset()
     }
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the state of all physical objects.
+ */
+void TrackObjectManager::saveState(Snapshot *s) const
+{
+    for (unsigned int i = 0; i < m_all_objects.size(); i++)
+    {
+        const PhysicalObject *po = m_all_objects.get(i)->getPhysicalObject();
+        if (po) po->saveState(s);
+    }
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void TrackObjectManager::restoreState(Snapshot *s)
+{
+    for (TrackObject* curr : m_all_objects)
+    {
+        PhysicalObject *po = curr->getPhysicalObject();
+        if (po) po->restoreState(s);
+    }
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** returns a reference to the track object
  *  with a particular ID
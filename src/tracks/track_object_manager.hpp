@@ -27,6 +27,7 @@ class Track;
 class Vec3;
 class XMLNode;
 class LODNode;
+class Snapshot;
 
 #include <map>
 #include <vector>
@@ -55,6 +56,8 @@ public:
          TrackObjectManager();
         ~TrackObjectManager();
     void reset();
+    void saveState(Snapshot *s) const;
+    void restoreState(Snapshot *s);
     void init();
     void add(const XMLNode &xml_node, scene::ISceneNode* parent,
              ModelDefinitionLoader& model_def_loader,
@@ -207,7 +207,7 @@ TrackObjectPresentationLibraryNode::TrackObjectPresentationLibraryNode(
         if (local_lib_node_path.size() > 0 && file_manager->fileExists(local_lib_node_path))
         {
             lib_path = track->getTrackFile("library/" + name);
-            libroot = file_manager->createXMLTree(local_lib_node_path);
+            libroot = file_manager->createCachedXMLTree(local_lib_node_path);
             if (track != NULL)
             {
                 Scripting::ScriptEngine::getInstance()->loadScript(local_script_file_path, false);
@@ -215,7 +215,7 @@ TrackObjectPresentationLibraryNode::TrackObjectPresentationLibraryNode(
         }
         else if (file_manager->fileExists(lib_node_path))
         {
-            libroot = file_manager->createXMLTree(lib_node_path);
+            libroot = file_manager->createCachedXMLTree(lib_node_path);
             if (track != NULL)
             {
                 Scripting::ScriptEngine::getInstance()->loadScript(lib_script_file_path, false);
@@ -27,6 +27,7 @@
 #include "tracks/arena_node.hpp"
 #include "tracks/drive_graph.hpp"
 #include "tracks/drive_node.hpp"
+#include "utils/snapshot.hpp"
 
 // ----------------------------------------------------------------------------
 /** Initialises the object, and sets the current graph node to be undefined.
@@ -46,6 +47,32 @@ void TrackSector::reset()
     m_last_triggered_checkline   = -1;
 }   // reset
 
+// ----------------------------------------------------------------------------
+void TrackSector::saveState(Snapshot *s) const
+{
+    s->add(m_current_graph_node);
+    s->add(m_estimated_valid_graph_node);
+    s->add(m_last_valid_graph_node);
+    s->add(m_current_track_coords);
+    s->add(m_estimated_valid_track_coords);
+    s->add(m_latest_valid_track_coords);
+    s->add(m_on_road);
+    s->add(m_last_triggered_checkline);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+void TrackSector::restoreState(Snapshot *s)
+{
+    s->get(&m_current_graph_node);
+    s->get(&m_estimated_valid_graph_node);
+    s->get(&m_last_valid_graph_node);
+    m_current_track_coords         = s->getVec3();
+    m_estimated_valid_track_coords = s->getVec3();
+    m_latest_valid_track_coords    = s->getVec3();
+    s->get(&m_on_road);
+    s->get(&m_last_triggered_checkline);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Updates the current graph node index, and the track coordinates for
  *  the specified point.
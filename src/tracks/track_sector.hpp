@@ -21,6 +21,7 @@
 
 #include "utils/vec3.hpp"
 
+class Snapshot;
 class Track;
 
 /** This object keeps track of which sector an object is on. A sector is
@@ -63,6 +64,8 @@ private:
 public:
           TrackSector();
     void  reset();
+    void  saveState(Snapshot *s) const;
+    void  restoreState(Snapshot *s);
     void  rescue();
     void  update(const Vec3 &xyz, bool ignore_vertical = false);
     float getRelativeDistanceToCenter() const;
@@ -0,0 +1,30 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/phase_timer.hpp"
+
+bool   PhaseTimer::m_enabled = false;
+double PhaseTimer::m_total[PhaseTimer::PHASE_COUNT] = { 0 };
+
+// ----------------------------------------------------------------------------
+/** Sets the time of all phases to 0. */
+void PhaseTimer::reset()
+{
+    for (int i = 0; i < PHASE_COUNT; i++)
+        m_total[i] = 0;
+}   // reset
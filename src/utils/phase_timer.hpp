@@ -0,0 +1,83 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_PHASE_TIMER_HPP
+#define HEADER_PHASE_TIMER_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <chrono>
+
+/** \brief Accumulates the wall time spent in phases of a world update that
+ *  can not be timed from the outside, e.g. the physics and the kart
+ *  controllers which are both updated within World::update. It is used by
+ *  the benchmark (pystk_cpp/benchmark.cpp) and is disabled by default, in
+ *  which case a scope only tests a flag.
+ *  \ingroup utils
+ */
+class PhaseTimer : public NoCopy
+{
+public:
+    enum Phase
+    {
+        PHASE_PHYSICS,
+        PHASE_CONTROLLER,
+        PHASE_COUNT
+    };
+
+    /** Adds the time from construction to destruction to a phase. */
+    class Scope : public NoCopy
+    {
+    private:
+        Phase m_phase;
+        std::chrono::steady_clock::time_point m_start;
+    public:
+        Scope(Phase phase) : m_phase(phase)
+        {
+            if (m_enabled)
+                m_start = std::chrono::steady_clock::now();
+        }   // Scope
+        // --------------------------------------------------------------------
+        ~Scope()
+        {
+            if (m_enabled)
+            {
+                m_total[m_phase] += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - m_start).count();
+            }
+        }   // ~Scope
+    };   // Scope
+
+private:
+    static bool   m_enabled;
+    static double m_total[PHASE_COUNT];
+
+public:
+    static void reset();
+    // ------------------------------------------------------------------------
+    /** Enables or disables timing of all phases. */
+    static void setEnabled(bool enabled) { m_enabled = enabled; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the phases are timed. */
+    static bool isEnabled() { return m_enabled; }
+    // ------------------------------------------------------------------------
+    /** Returns the time spent in a phase since the last reset in seconds. */
+    static double getTotal(Phase phase) { return m_total[phase]; }
+};   // PhaseTimer
+
+#endif
@@ -78,6 +78,9 @@ class AbstractSingleton
 
     private:
         static T *m_singleton;
+
+        /** A RaceContext swaps the instance of each race in and out. */
+        friend class RaceContext;
 };
 
 template <typename T> T *AbstractSingleton<T>::m_singleton = NULL;
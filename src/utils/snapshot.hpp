@@ -0,0 +1,133 @@
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2020 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_SNAPSHOT_HPP
+#define HEADER_SNAPSHOT_HPP
+
+#include "LinearMath/btTransform.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+/** \brief A compact binary blob that holds the simulation state of a race.
+ *  Objects append their state with saveState(Snapshot*) and read it back in
+ *  the same order in restoreState(Snapshot*). The blob is only valid for the
+ *  race (track, karts, mode) it was taken from.
+ *  \ingroup utils
+ */
+class Snapshot
+{
+private:
+    std::string m_data;
+    size_t      m_read_pos;
+
+    void read(void *dst, size_t n)
+    {
+        if (m_read_pos + n > m_data.size())
+            throw std::runtime_error("Snapshot is truncated or does not "
+                                     "match the current race");
+        memcpy(dst, m_data.data() + m_read_pos, n);
+        m_read_pos += n;
+    }   // read
+
+public:
+    Snapshot() : m_read_pos(0) {}
+    // ------------------------------------------------------------------------
+    Snapshot(const std::string &data) : m_data(data), m_read_pos(0) {}
+    // ------------------------------------------------------------------------
+    /** Appends a plain value (no pointers or owning members). Vectors
+     *  and transforms use the overloads below. */
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value ||
+                            std::is_enum<T>::value>::type add(const T &v)
+    {
+        m_data.append((const char*)&v, sizeof(T));
+    }   // add
+    // ------------------------------------------------------------------------
+    void add(const btVector3 &v)
+    {
+        add(v.getX()); add(v.getY()); add(v.getZ());
+    }   // add(btVector3)
+    // ------------------------------------------------------------------------
+    void add(const btQuaternion &q)
+    {
+        add(q.getX()); add(q.getY()); add(q.getZ()); add(q.getW());
+    }   // add(btQuaternion)
+    // ------------------------------------------------------------------------
+    void add(const btTransform &t)
+    {
+        add(t.getOrigin()); add(t.getRotation());
+    }   // add(btTransform)
+    // ------------------------------------------------------------------------
+    template<typename T> T get()
+    {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                      "Only arithmetic and enum values can be read");
+        T v;
+        read(&v, sizeof(T));
+        return v;
+    }   // get
+    // ------------------------------------------------------------------------
+    template<typename T> void get(T *v) { *v = get<T>(); }
+    // ------------------------------------------------------------------------
+    btVector3 getVec3()
+    {
+        btScalar x = get<btScalar>();
+        btScalar y = get<btScalar>();
+        btScalar z = get<btScalar>();
+        return btVector3(x, y, z);
+    }   // getVec3
+    // ------------------------------------------------------------------------
+    btQuaternion getQuat()
+    {
+        btScalar x = get<btScalar>();
+        btScalar y = get<btScalar>();
+        btScalar z = get<btScalar>();
+        btScalar w = get<btScalar>();
+        return btQuaternion(x, y, z, w);
+    }   // getQuat
+    // ------------------------------------------------------------------------
+    btTransform getTransform()
+    {
+        btVector3 origin = getVec3();
+        return btTransform(getQuat(), origin);
+    }   // getTransform
+    // ------------------------------------------------------------------------
+    /** Appends a string (e.g. a serialized random engine). */
+    void addString(const std::string &s)
+    {
+        add((uint32_t)s.size());
+        m_data.append(s);
+    }   // addString
+    // ------------------------------------------------------------------------
+    std::string getString()
+    {
+        std::string s(get<uint32_t>(), '\0');
+        if (!s.empty())
+            read(&s[0], s.size());
+        return s;
+    }   // getString
+    // ------------------------------------------------------------------------
+    const std::string& getData() const { return m_data; }
+    // ------------------------------------------------------------------------
+    /** True if all data was read back. */
+    bool isFullyRead() const { return m_read_pos == m_data.size(); }
+};   // Snapshot
+
+#endif
@@ -0,0 +1,52 @@
+#!/usr/bin/env python
+"""
+Fills the compressed texture cache of pystk for all karts and tracks.
+
+Textures are compressed the first time they are loaded and stored in
+$XDG_CACHE_HOME/supertuxkart/cached-textures, later processes load the
+compressed textures directly. Run this once (e.g. when building a container image, with
+XDG_CACHE_HOME pointing into the image) to avoid compressing textures in the
+first race of every track.
+
+Only configs with texture_compression use the cache. The cache has one
+directory per texture size: 'hd' for high_definition_textures, and
+'resized_<max_texture_size>' otherwise. Each variant is filled once.
+"""
+import argparse
+import subprocess
+import sys
+
+SIZES = [128, 256, 512, 1024, 2048]
+VARIANTS = ['hd'] + ['resized_%d' % s for s in SIZES]
+
+
+def graphics_config(variant):
+    import pystk
+    config = pystk.GraphicsConfig.sd()
+    config.texture_compression = True
+    if variant == 'hd':
+        config.high_definition_textures = 1 | 2
+    else:
+        config.high_definition_textures = 0
+        config.max_texture_size = int(variant[len('resized_'):])
+    return config
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-v', '--variant', choices=VARIANTS, nargs='+', default=VARIANTS)
+    args = parser.parse_args()
+
+    if len(args.variant) > 1:
+        # pystk can only be initialized once per process
+        for v in args.variant:
+            subprocess.check_call([sys.executable, __file__, '-v', v])
+    else:
+        import pystk
+        from time import time
+
+        t0 = time()
+        pystk.init(graphics_config(args.variant[0]))
+        pystk.warm_texture_cache()
+        pystk.clean()
+        print('%s: warmed the texture cache in %0.1fs' % (args.variant[0], time() - t0))